@@ -18,6 +18,7 @@
 #include <limits.h>
 #include <time.h>
 #include <sys/time.h>
+#include <pthread.h>
 
 #include "sg_lib.h"
 #include "sg_cmds_basic.h"
@@ -53,6 +54,26 @@ static int sect_sz;
 static char log_path[128] = { 0 };
 static FILE *log_fp = NULL;
 
+static int num_threads = DEFAULT_THREADS;
+static int queue_depth = DEFAULT_QUEUE_DEPTH;
+static int write_ahead = 0;     /* wr: groups written ahead of the verify */
+
+/* one slice of the test range, walked by a thread on its own fd */
+struct io_worker {
+    pthread_t thread;
+    int id;
+    const char *path;
+    int fd;
+    int depth;              /* commands in flight on 'fd' */
+    int mode;
+    int64_t start_lba;
+    int64_t total_blk;
+    int xfer_sz;
+    int iter;
+    int duration;
+    int res;
+};
+
 static void usage(void)
 {
     fprintf(stderr, "\n\t%s\n", BANNER);
@@ -74,12 +95,17 @@ static void usage(void)
             "\t-s    starting logical block address (default: 0)\n"
             "\t-t    calculate time and throughput\n"
             "\t-l    specify log file path (default: none)\n"
+            "\t-j    number of threads, each on a slice of the range (default: 1)\n"
+            "\t-q    commands in flight per thread, sg devices only (default: 1, max: %d)\n"
+            "\t-a    wr: write N transfers (of -q) ahead of the verify (default: 0, off)\n"
             "\t-v    verbose\n"
-            "\n"
+            "\n", SG_MAX_QUEUE
             );
     fprintf(stderr, "ex:\n"
             "\tdiskio /dev/sda wr -b=128k -m=32M -p=0xaaaa5555\n"
-            "\tdiskio /dev/sdb w -b=256k -s=1000 -l=/tmp/diskio_log.txt\n");
+            "\tdiskio /dev/sdb w -b=256k -s=1000 -l=/tmp/diskio_log.txt\n"
+            "\tdiskio /dev/sg2 r -b=64k -j=4 -q=8 -t\n"
+            "\tdiskio /dev/sdc wr -b=1M -a=3 -t\n");
 }
 
 static void open_log(void)
@@ -250,87 +276,94 @@ static int build_scsi_cdb(unsigned char * cdbp, int cdb_sz,
     return 0;
 }
 
-static int scsi_read(int fd, void *buff,
-        int blocks, int64_t from_block, int bs)
+/* Builds the sg v3 header of a READ or WRITE (10 or 16 byte cdb) of
+ * 'blocks' at 'lba' into 'io_hdr'; 'cdbp' and 'sbp' belong to the caller.
+ * Returns 0 or SG_LIB_SYNTAX_ERROR. */
+static int scsi_rw_prep(struct sg_io_hdr *io_hdr, unsigned char *cdbp,
+        unsigned char *sbp, int write_true, void *buff,
+        int blocks, int64_t lba, int bs)
 {
-    unsigned char rdCmd[MAX_SCSI_CDBSZ];
-    unsigned char senseBuff[SENSE_BUFF_LEN];
-    const unsigned char * sbp;
-    struct sg_io_hdr io_hdr;
-    int res, k, info_valid, slen, cdb_sz;
-    uint64_t io_addr;
+    int k, cdb_sz;
 
-    if (from_block > 0xffffffff) {
-        rdCmd[0] = 0x88; /* read_16 */
+    if (lba > 0xffffffff) {
+        cdbp[0] = write_true ? 0x8a : 0x88; /* write_16 / read_16 */
         cdb_sz = 16;
     } else {
-        rdCmd[0] = 0x28; /* read_10 */
+        cdbp[0] = write_true ? 0x2a : 0x28; /* write_10 / read_10 */
         cdb_sz = 10;
     }
 
-    if (build_scsi_cdb(rdCmd, cdb_sz, blocks, from_block)) {
-        fprintf(stderr, ME "bad rd cdb build, from_block=%" PRId64
-                ", blocks=%d\n", from_block, blocks);
+    if (build_scsi_cdb(cdbp, cdb_sz, blocks, lba)) {
+        fprintf(stderr, ME "bad %s cdb build, %s_block=%"PRId64
+                ", blocks=%d\n", write_true ? "wr" : "rd",
+                write_true ? "to" : "from", lba, blocks);
         return SG_LIB_SYNTAX_ERROR;
     }
 
-    memset(&io_hdr, 0, sizeof(struct sg_io_hdr));
-    io_hdr.interface_id = 'S';
-    io_hdr.cmd_len = cdb_sz;
-    io_hdr.cmdp = rdCmd;
-    io_hdr.dxfer_direction = SG_DXFER_FROM_DEV;
-    io_hdr.dxfer_len = bs * blocks;
-    io_hdr.dxferp = buff;
-    io_hdr.mx_sb_len = SENSE_BUFF_LEN;
-    io_hdr.sbp = senseBuff;
-    io_hdr.timeout = DEF_TIMEOUT;
-    io_hdr.pack_id = (int)from_block;
-    io_hdr.flags |= SG_FLAG_DIRECT_IO; /* direct I/O */
+    memset(io_hdr, 0, sizeof(struct sg_io_hdr));
+    io_hdr->interface_id = 'S';
+    io_hdr->cmd_len = cdb_sz;
+    io_hdr->cmdp = cdbp;
+    io_hdr->dxfer_direction = write_true ? SG_DXFER_TO_DEV :
+                                           SG_DXFER_FROM_DEV;
+    io_hdr->dxfer_len = bs * blocks;
+    io_hdr->dxferp = buff;
+    io_hdr->mx_sb_len = SENSE_BUFF_LEN;
+    io_hdr->sbp = sbp;
+    io_hdr->timeout = DEF_TIMEOUT;
+    io_hdr->pack_id = (int)lba;
+    io_hdr->flags |= SG_FLAG_DIRECT_IO; /* direct I/O */
 
     if (verbose > 2) {
-        fprintf(stderr, "    read cdb: ");
+        fprintf(stderr, "    %s cdb: ", write_true ? "write" : "read");
         for (k = 0; k < cdb_sz; ++k)
-            fprintf(stderr, "%02x ", rdCmd[k]);
+            fprintf(stderr, "%02x ", cdbp[k]);
         fprintf(stderr, "\n");
     }
-    while (((res = ioctl(fd, SG_IO, &io_hdr)) < 0) && (EINTR == errno));
+    return 0;
+}
+
+/* Checks a completed READ, returns 0 or a SG_LIB_CAT_* value */
+static int scsi_read_chk(struct sg_io_hdr *io_hdr,
+        int blocks, int64_t from_block)
+{
+    char sense_str[128];
+    const unsigned char * sbp;
+    int res, info_valid, slen;
+    uint64_t io_addr;
 
-    if (res < 0) {
-        if (ENOMEM == errno)
-            return -2;
-        perror("reading (SG_IO) on sg device, error");
-        return -1;
-    }
     if (verbose > 2)
-        fprintf(stderr, "      duration=%u ms\n", io_hdr.duration);
-    res = sg_err_category3(&io_hdr);
-    sbp = io_hdr.sbp;
-    slen = io_hdr.sb_len_wr;
+        fprintf(stderr, "      duration=%u ms\n", io_hdr->duration);
+    res = sg_err_category3(io_hdr);
+    sbp = io_hdr->sbp;
+    slen = io_hdr->sb_len_wr;
     switch (res) {
     case SG_LIB_CAT_CLEAN:
         break;
     case SG_LIB_CAT_RECOVERED:
-        ++recovered_errs;
+        __sync_fetch_and_add(&recovered_errs, 1);
         info_valid = sg_get_sense_info_fld(sbp, slen, &io_addr);
         if (info_valid) {
+            sg_get_sense_brief_str(sbp, slen, sizeof(sense_str),
+                                   sense_str);
             fprintf(stderr, "    lba of last recovered error in this "
-                    "READ=0x%"PRIx64"\n", io_addr);
+                    "READ=0x%"PRIx64": %s\n", io_addr, sense_str);
             if (verbose > 1)
-                sg_chk_n_print3("reading", &io_hdr, 1);
+                sg_chk_n_print3("reading", io_hdr, 1);
         } else {
             fprintf(stderr, "Recovered error: [no info] reading from "
                     "block=0x%"PRIx64", num=%d\n", from_block, blocks);
-            sg_chk_n_print3("reading", &io_hdr, verbose > 1);
+            sg_chk_n_print3("reading", io_hdr, verbose > 1);
         }
         break;
     case SG_LIB_CAT_ABORTED_COMMAND:
     case SG_LIB_CAT_UNIT_ATTENTION:
-        sg_chk_n_print3("reading", &io_hdr, verbose > 1);
+        sg_chk_n_print3("reading", io_hdr, verbose > 1);
         return res;
     case SG_LIB_CAT_MEDIUM_HARD:
         if (verbose > 1)
-            sg_chk_n_print3("reading", &io_hdr, verbose > 1);
-        ++unrecovered_errs;
+            sg_chk_n_print3("reading", io_hdr, verbose > 1);
+        __sync_fetch_and_add(&unrecovered_errs, 1);
         info_valid = sg_get_sense_info_fld(sbp, slen, &io_addr);
         if ((info_valid) && (io_addr > 0))
             return SG_LIB_CAT_MEDIUM_HARD_WITH_INFO;
@@ -341,120 +374,283 @@ static int scsi_read(int fd, void *buff,
         }
         break;
     case SG_LIB_CAT_NOT_READY:
-        ++unrecovered_errs;
+        __sync_fetch_and_add(&unrecovered_errs, 1);
         if (verbose > 0)
-            sg_chk_n_print3("reading", &io_hdr, verbose > 1);
+            sg_chk_n_print3("reading", io_hdr, verbose > 1);
         return res;
     case SG_LIB_CAT_ILLEGAL_REQ:
         /* drop through */
     default:
-        ++unrecovered_errs;
+        __sync_fetch_and_add(&unrecovered_errs, 1);
         if (verbose > 0)
-            sg_chk_n_print3("reading", &io_hdr, verbose > 1);
+            sg_chk_n_print3("reading", io_hdr, verbose > 1);
         return res;
     }
 
-    sum_of_resids += io_hdr.resid;
-    in_full += blocks;
+    __sync_fetch_and_add(&sum_of_resids, io_hdr->resid);
+    __sync_fetch_and_add(&in_full, blocks);
     return 0;
 }
 
-static int scsi_write(int fd, void *buff,
-        int blocks, int64_t to_block, int bs)
+static int scsi_read(int fd, void *buff,
+        int blocks, int64_t from_block, int bs)
 {
-    unsigned char wrCmd[MAX_SCSI_CDBSZ];
+    unsigned char rdCmd[MAX_SCSI_CDBSZ];
     unsigned char senseBuff[SENSE_BUFF_LEN];
     struct sg_io_hdr io_hdr;
-    int res, k, info_valid, cdb_sz;
-    uint64_t io_addr = 0;
-
-    if (to_block > 0xffffffff) {
-        wrCmd[0] = 0x8a; /* write_16 */
-        cdb_sz = 16;
-    } else {
-        wrCmd[0] = 0x2a; /* write_10 */
-        cdb_sz = 10;
-    }
-
-    if (build_scsi_cdb(wrCmd, cdb_sz, blocks, to_block)) {
-        fprintf(stderr, ME "bad wr cdb build, to_block=%"PRId64", blocks=%d\n",
-                to_block, blocks);
-        return SG_LIB_SYNTAX_ERROR;
-    }
+    int res;
 
-    memset(&io_hdr, 0, sizeof(struct sg_io_hdr));
-    io_hdr.interface_id = 'S';
-    io_hdr.cmd_len = cdb_sz;
-    io_hdr.cmdp = wrCmd;
-    io_hdr.dxfer_direction = SG_DXFER_TO_DEV;
-    io_hdr.dxfer_len = bs * blocks;
-    io_hdr.dxferp = buff;
-    io_hdr.mx_sb_len = SENSE_BUFF_LEN;
-    io_hdr.sbp = senseBuff;
-    io_hdr.timeout = DEF_TIMEOUT;
-    io_hdr.pack_id = (int)to_block;
-    io_hdr.flags |= SG_FLAG_DIRECT_IO; /* direct I/O */
+    res = scsi_rw_prep(&io_hdr, rdCmd, senseBuff, 0, buff, blocks,
+                       from_block, bs);
+    if (res)
+        return res;
+    while (((res = ioctl(fd, SG_IO, &io_hdr)) < 0) && (EINTR == errno));
 
-    if (verbose > 2) {
-        fprintf(stderr, "    write cdb: ");
-        for (k = 0; k < cdb_sz; ++k)
-            fprintf(stderr, "%02x ", wrCmd[k]);
-        fprintf(stderr, "\n");
-    }
-    while (((res = ioctl(fd, SG_IO, &io_hdr)) < 0) && (EINTR == errno))
-        ;
     if (res < 0) {
         if (ENOMEM == errno)
             return -2;
-        perror("writing (SG_IO) on sg device, error");
+        perror("reading (SG_IO) on sg device, error");
         return -1;
     }
+    return scsi_read_chk(&io_hdr, blocks, from_block);
+}
+
+/* Checks a completed WRITE, returns 0 or a SG_LIB_CAT_* value */
+static int scsi_write_chk(struct sg_io_hdr *io_hdr,
+        int blocks, int64_t to_block)
+{
+    char sense_str[128];
+    int res, info_valid;
+    uint64_t io_addr = 0;
 
     if (verbose > 2)
-        fprintf(stderr, "      duration=%u ms\n", io_hdr.duration);
-    res = sg_err_category3(&io_hdr);
+        fprintf(stderr, "      duration=%u ms\n", io_hdr->duration);
+    res = sg_err_category3(io_hdr);
     switch (res) {
     case SG_LIB_CAT_CLEAN:
         break;
     case SG_LIB_CAT_RECOVERED:
-        ++recovered_errs;
-        info_valid = sg_get_sense_info_fld(io_hdr.sbp, io_hdr.sb_len_wr,
+        __sync_fetch_and_add(&recovered_errs, 1);
+        info_valid = sg_get_sense_info_fld(io_hdr->sbp, io_hdr->sb_len_wr,
                                            &io_addr);
         if (info_valid) {
+            sg_get_sense_brief_str(io_hdr->sbp, io_hdr->sb_len_wr,
+                                   sizeof(sense_str), sense_str);
             fprintf(stderr, "    lba of last recovered error in this "
-                    "WRITE=0x%"PRIx64"\n", io_addr);
+                    "WRITE=0x%"PRIx64": %s\n", io_addr, sense_str);
             if (verbose > 1)
-                sg_chk_n_print3("writing", &io_hdr, 1);
+                sg_chk_n_print3("writing", io_hdr, 1);
         } else {
             fprintf(stderr, "Recovered error: [no info] writing to "
                     "block=0x%"PRIx64", num=%d\n", to_block, blocks);
-            sg_chk_n_print3("writing", &io_hdr, verbose > 1);
+            sg_chk_n_print3("writing", io_hdr, verbose > 1);
         }
         break;
     case SG_LIB_CAT_ABORTED_COMMAND:
     case SG_LIB_CAT_UNIT_ATTENTION:
-        sg_chk_n_print3("writing", &io_hdr, verbose > 1);
+        sg_chk_n_print3("writing", io_hdr, verbose > 1);
         return res;
     case SG_LIB_CAT_NOT_READY:
-        ++unrecovered_errs;
+        __sync_fetch_and_add(&unrecovered_errs, 1);
         fprintf(stderr, "device not ready (w)\n");
         return res;
     case SG_LIB_CAT_MEDIUM_HARD:
     default:
-        sg_chk_n_print3("writing", &io_hdr, verbose > 1);
-        ++unrecovered_errs;
+        sg_chk_n_print3("writing", io_hdr, verbose > 1);
+        __sync_fetch_and_add(&unrecovered_errs, 1);
         
         return res;
     }
 
-    out_full += blocks;
+    __sync_fetch_and_add(&out_full, blocks);
     return 0;
 }
 
-static int __read_op(int fd, void *buff,
-        int64_t start_lba, int total_blk, int xfer_blk)
+static int scsi_write(int fd, void *buff,
+        int blocks, int64_t to_block, int bs)
 {
+    unsigned char wrCmd[MAX_SCSI_CDBSZ];
+    unsigned char senseBuff[SENSE_BUFF_LEN];
+    struct sg_io_hdr io_hdr;
     int res;
+
+    res = scsi_rw_prep(&io_hdr, wrCmd, senseBuff, 1, buff, blocks,
+                       to_block, bs);
+    if (res)
+        return res;
+    while (((res = ioctl(fd, SG_IO, &io_hdr)) < 0) && (EINTR == errno))
+        ;
+    if (res < 0) {
+        if (ENOMEM == errno)
+            return -2;
+        perror("writing (SG_IO) on sg device, error");
+        return -1;
+    }
+    return scsi_write_chk(&io_hdr, blocks, to_block);
+}
+
+/* Collects the 'inflight' commands still queued on an sg device node, so
+ * that no completion refers to buffers or slots of a finished call. What
+ * can't be read back is dropped with the open file: the node is opened
+ * again onto the same descriptor, the sg driver discards the responses
+ * of a closed file. Returns 0, or -1 if the fd couldn't be reopened. */
+static int sg_drain(int fd, int inflight)
+{
+    struct sg_io_hdr io_hdr;
+    char path[64];
+    int n, nfd;
+
+    while (inflight) {
+        memset(&io_hdr, 0, sizeof(io_hdr));
+        io_hdr.interface_id = 'S';
+        while (((n = read(fd, &io_hdr, sizeof(io_hdr))) < 0) &&
+               (EINTR == errno))
+            ;
+        if (n < 0)
+            break;
+        inflight--;
+    }
+    if (!inflight)
+        return 0;
+
+    snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+    if ((nfd = open(path, fcntl(fd, F_GETFL) & (O_ACCMODE | O_NONBLOCK))) < 0
+        || dup2(nfd, fd) < 0) {
+        perror("dropping commands on sg device, error");
+        if (nfd >= 0)
+            close(nfd);
+        return -1;
+    }
+    close(nfd);
+    return 0;
+}
+
+/* Keeps up to 'depth' READs or WRITEs of 'xfer_blk' blocks outstanding
+ * on an sg device node with the asynchronous write()/read() interface.
+ * Command k transfers at 'bufs' + k * 'stride' (a zero 'stride' shares
+ * one buffer between writes); read data is compared to 'data' if given.
+ * Returns 0 or, of the failed commands, the first error. */
+static int queued_op(int fd, int depth, int write_true,
+        unsigned char *bufs, size_t stride,
+        int64_t start_lba, int64_t total_blk, int xfer_blk, const void *data)
+{
+    struct sg_slot {
+        struct sg_io_hdr io_hdr;
+        unsigned char cdb[MAX_SCSI_CDBSZ];
+        unsigned char sense[SENSE_BUFF_LEN];
+        unsigned char *buff;
+        int blocks;
+        int64_t lba;
+    } slots[SG_MAX_QUEUE], *sp;
+    struct sg_io_hdr io_hdr;
+    int free_ids[SG_MAX_QUEUE];
+    int k, n, blocks, nfree, inflight = 0;
+    int res = 0;
+
+    for (k = 0; k < depth; k++)
+        free_ids[k] = k;
+    nfree = depth;
+
+    while (total_blk || inflight) {
+        while (total_blk && nfree && !res) {
+            blocks = (total_blk > xfer_blk) ? xfer_blk : total_blk;
+            k = free_ids[--nfree];
+            sp = &slots[k];
+            sp->buff = bufs + k * stride;
+            sp->blocks = blocks;
+            sp->lba = start_lba;
+            res = scsi_rw_prep(&sp->io_hdr, sp->cdb, sp->sense, write_true,
+                               sp->buff, blocks, start_lba, sect_sz);
+            if (!res) {
+                sp->io_hdr.usr_ptr = sp;
+                while (((n = write(fd, &sp->io_hdr, sizeof(sp->io_hdr))) < 0)
+                       && (EINTR == errno))
+                    ;
+                if (n < 0) {
+                    perror("queueing command on sg device, error");
+                    res = -1;
+                }
+            }
+            if (res) {
+                free_ids[nfree++] = k;
+                break;
+            }
+            inflight++;
+            start_lba += blocks;
+            total_blk -= blocks;
+        }
+        if (!inflight)
+            break;
+
+        /* completions come back in any order */
+        memset(&io_hdr, 0, sizeof(io_hdr));
+        io_hdr.interface_id = 'S';
+        while (((n = read(fd, &io_hdr, sizeof(io_hdr))) < 0) &&
+               (EINTR == errno))
+            ;
+        if (n < 0) {
+            perror("reaping command on sg device, error");
+            /* the rest point into slots[], gone once this returns */
+            sg_drain(fd, inflight);
+            return -1;
+        }
+        inflight--;
+        sp = (struct sg_slot *)io_hdr.usr_ptr;
+
+        n = write_true ? scsi_write_chk(&io_hdr, sp->blocks, sp->lba) :
+                         scsi_read_chk(&io_hdr, sp->blocks, sp->lba);
+        if (n == SG_LIB_CAT_UNIT_ATTENTION)     /* retry */
+            n = write_true ? scsi_write(fd, sp->buff, sp->blocks, sp->lba,
+                                        sect_sz) :
+                             scsi_read(fd, sp->buff, sp->blocks, sp->lba,
+                                       sect_sz);
+        if (!n && data && memcmp(sp->buff, data, (sp->blocks*sect_sz))) {
+            fprintf(stderr, "ERROR: data compare error, start LBA %"PRId64"\n",
+                    sp->lba);
+            n = -1;
+        }
+        if (n && !res)
+            res = n;
+        free_ids[nfree++] = sp - slots;
+    }
+
+    return res;
+}
+
+/* Only the sg driver queues commands by write()/read() on its nodes; block
+ * devices (and bsg) take SG_IO synchronously, so they get a depth of 1 */
+static int probe_depth(int fd)
+{
+    struct stat st;
+    int waiting;
+
+    if (queue_depth < 2)
+        return 1;
+    if ((fstat(fd, &st) < 0) || !S_ISCHR(st.st_mode) ||
+        (ioctl(fd, SG_GET_NUM_WAITING, &waiting) < 0))
+        return 1;
+
+    /* completions are waited for in read() */
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+    return queue_depth;
+}
+
+static void fill_pattern(void *buff, int len, unsigned int seed)
+{
+    int i;
+
+    for (i = 0; i < (len/4); i++) {
+        if (use_random_pattern)
+            *(((int*)buff) + i) = rand_r(&seed);
+        else
+            *(((int*)buff) + i) = user_pattern;
+    }
+}
+
+static int __read_op(int fd, void *buff,
+        int64_t start_lba, int64_t total_blk, int xfer_blk)
+{
+    int res = 0;
     int blocks;
 
     while (total_blk) {
@@ -477,60 +673,36 @@ static int __read_op(int fd, void *buff,
     return res;
 }
 
-static int read_op(int fd, int64_t start_lba,
-        int64_t test_sz, int xfer_sz, int iter, int duration)
+static int __write_op(int fd, void *buff,
+        int64_t start_lba, int64_t total_blk, int xfer_blk)
 {
-    int res;
-    void *wrkBuff;
-    void *wrkPos;
-    int64_t total_blk;
-    int64_t xfer_blk;
-
-    wrkBuff = malloc(xfer_sz + sysconf(_SC_PAGESIZE));
-    if (wrkBuff == NULL) {
-        fprintf(stderr, "Not enough user memory\n");
-        return -1;
-    }
-    wrkPos = (void*) (((unsigned long)wrkBuff + sysconf(_SC_PAGESIZE) - 1)
-            & (~(sysconf(_SC_PAGESIZE) - 1)));
-
-    total_blk = test_sz/sect_sz;
-    xfer_blk = xfer_sz/sect_sz;
+    int res = 0;
+    int blocks;
 
-    if (iter == 0)
-        iter = UINT_MAX;
+    while (total_blk) {
+        if (total_blk - xfer_blk > 0)
+            blocks = xfer_blk;
+        else
+            blocks = total_blk;
 
-    if (do_time) {
-        start_tm.tv_sec = 0;
-        start_tm.tv_usec = 0;
-        gettimeofday(&start_tm, NULL);
-        start_tm_valid = 1;
-    }
+        res = scsi_write(fd, buff, blocks, start_lba, sect_sz);
+        if (res == SG_LIB_CAT_UNIT_ATTENTION)
+            res = scsi_write(fd, buff, blocks, start_lba, sect_sz); /* retry */
 
-    while (iter) {
-        
-        res = __read_op(fd, wrkPos, start_lba, total_blk, xfer_blk);
         if (res)
             break;
 
-        iter--;
-        
-        if (do_time && iter)
-            calc_duration_throughput(1);
+        total_blk -= blocks;
+        start_lba += blocks;
     }
 
-    if (do_time)
-        calc_duration_throughput(0);
-
-    free(wrkBuff);
-
     return res;
 }
 
-static int __write_op(int fd, void *buff,
-        int64_t start_lba, int total_blk, int xfer_blk)
+static int read_and_compare(int fd, void *buff,
+        int64_t start_lba, int64_t total_blk, int xfer_blk, void *data)
 {
-    int res;
+    int res = 0;
     int blocks;
 
     while (total_blk) {
@@ -539,13 +711,20 @@ static int __write_op(int fd, void *buff,
         else
             blocks = total_blk;
 
-        res = scsi_write(fd, buff, blocks, start_lba, sect_sz);
+        memset(buff, 0, (xfer_blk*sect_sz));
+        res = scsi_read(fd, buff, blocks, start_lba, sect_sz);
         if (res == SG_LIB_CAT_UNIT_ATTENTION)
-            res = scsi_write(fd, buff, blocks, start_lba, sect_sz); /* retry */
+            res = scsi_read(fd, buff, blocks, start_lba, sect_sz); /* retry */
 
         if (res)
             break;
 
+        if (memcmp(buff, data, (blocks*sect_sz))) {
+            fprintf(stderr, "ERROR: data compare error, start LBA %"PRId64"\n", start_lba);
+            res = -1;
+            break;
+        }
+
         total_blk -= blocks;
         start_lba += blocks;
     }
@@ -553,17 +732,33 @@ static int __write_op(int fd, void *buff,
     return res;
 }
 
-static int write_op(int fd, int64_t start_lba,
-        int64_t test_sz, int xfer_sz, int iter, int duration)
+/* Reads ('data' non-NULL: and compares) or writes a range of the worker,
+ * queued when its device node allows. 'bufs' holds 'depth' transfers of
+ * 'stride' bytes each. */
+static int xfer_blocks(struct io_worker *w, int write_true,
+        void *bufs, size_t stride,
+        int64_t start_lba, int64_t total_blk, int xfer_blk, void *data)
+{
+    if (w->depth > 1)
+        return queued_op(w->fd, w->depth, write_true, bufs, stride,
+                         start_lba, total_blk, xfer_blk, data);
+    if (write_true)
+        return __write_op(w->fd, bufs, start_lba, total_blk, xfer_blk);
+    if (data)
+        return read_and_compare(w->fd, bufs, start_lba, total_blk, xfer_blk,
+                                data);
+    return __read_op(w->fd, bufs, start_lba, total_blk, xfer_blk);
+}
+
+static int read_op(struct io_worker *w)
 {
-    int res, i;
+    int res = 0;
     void *wrkBuff;
     void *wrkPos;
-    int64_t total_blk;
     int64_t xfer_blk;
-    int seed;
+    int iter = w->iter;
 
-    wrkBuff = malloc(xfer_sz + sysconf(_SC_PAGESIZE));
+    wrkBuff = malloc(w->xfer_sz * w->depth + sysconf(_SC_PAGESIZE));
     if (wrkBuff == NULL) {
         fprintf(stderr, "Not enough user memory\n");
         return -1;
@@ -571,100 +766,249 @@ static int write_op(int fd, int64_t start_lba,
     wrkPos = (void*) (((unsigned long)wrkBuff + sysconf(_SC_PAGESIZE) - 1)
             & (~(sysconf(_SC_PAGESIZE) - 1)));
 
-    /* fill in test pattern */
-    seed = time(NULL);
-    srand(seed);
-    for (i = 0; i < (xfer_sz/4); i++) {
-        if (use_random_pattern)
-            *(((int*)wrkPos) + i) = rand(); 
-        else
-            *(((int*)wrkPos) + i) = user_pattern;
-    }
-
-    total_blk = test_sz/sect_sz;
-    xfer_blk = xfer_sz/sect_sz;
+    xfer_blk = w->xfer_sz/sect_sz;
 
     if (iter == 0)
         iter = UINT_MAX;
 
-    if (do_time) {
-        start_tm.tv_sec = 0;
-        start_tm.tv_usec = 0;
-        gettimeofday(&start_tm, NULL);
-        start_tm_valid = 1;
+    while (iter) {
+        
+        res = xfer_blocks(w, 0, wrkPos, w->xfer_sz, w->start_lba,
+                          w->total_blk, xfer_blk, NULL);
+        if (res)
+            break;
+
+        iter--;
+        
+        if (do_time && iter && (w->id == 0))
+            calc_duration_throughput(1);
+    }
+
+    free(wrkBuff);
+
+    return res;
+}
+
+static int write_op(struct io_worker *w)
+{
+    int res = 0;
+    void *wrkBuff;
+    void *wrkPos;
+    int64_t xfer_blk;
+    int iter = w->iter;
+
+    wrkBuff = malloc(w->xfer_sz + sysconf(_SC_PAGESIZE));
+    if (wrkBuff == NULL) {
+        fprintf(stderr, "Not enough user memory\n");
+        return -1;
     }
+    wrkPos = (void*) (((unsigned long)wrkBuff + sysconf(_SC_PAGESIZE) - 1)
+            & (~(sysconf(_SC_PAGESIZE) - 1)));
+
+    /* fill in test pattern, all queued writes share it */
+    fill_pattern(wrkPos, w->xfer_sz, time(NULL) + w->id);
+
+    xfer_blk = w->xfer_sz/sect_sz;
+
+    if (iter == 0)
+        iter = UINT_MAX;
 
     while (iter) {
         
-        res = __write_op(fd, wrkPos, start_lba, total_blk, xfer_blk);
+        res = xfer_blocks(w, 1, wrkPos, 0, w->start_lba,
+                          w->total_blk, xfer_blk, NULL);
         if (res)
             break;
 
         iter--;
         
-        if (do_time && iter)
+        if (do_time && iter && (w->id == 0))
             calc_duration_throughput(1);
     }
 
-    if (do_time)
-        calc_duration_throughput(0);
-
     free(wrkBuff);
 
     return res;
 }
 
-static int read_and_compare(int fd, void *buff,
-        int64_t start_lba, int total_blk, int xfer_blk, void *data)
+/* position in the sequence of write/verify groups of write_read_op() */
+struct wr_cursor {
+    int64_t lba;
+    int64_t left;           /* blocks left in this pass */
+    int iter;               /* passes left */
+};
+
+static void wr_cursor_init(struct io_worker *w, struct wr_cursor *cur)
 {
+    cur->lba = w->start_lba;
+    cur->left = 0;
+    cur->iter = w->iter ? w->iter : (int)UINT_MAX;
+}
+
+/* Yields the next group ('depth' transfers) at '*lba', returns its blocks
+ * or 0 once all passes are done */
+static int64_t wr_next_group(struct io_worker *w, struct wr_cursor *cur,
+        int64_t *lba)
+{
+    int64_t span = (w->xfer_sz/sect_sz) * w->depth;
+    int64_t blocks;
+
+    if (cur->left == 0) {
+        if (cur->iter == 0)
+            return 0;
+        cur->iter--;
+        cur->lba = w->start_lba;
+        cur->left = w->total_blk;
+    }
+    blocks = (cur->left > span) ? span : cur->left;
+    *lba = cur->lba;
+    cur->lba += blocks;
+    cur->left -= blocks;
+    return blocks;
+}
+
+/* writer and verifier of a pipelined write_read_op() */
+struct wr_pipe {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    struct io_worker writer;    /* as the worker, but with its own fd */
+    void *wrPos;
+    int64_t written;            /* groups written */
+    int64_t verified;           /* groups read back and compared */
+    int stop;                   /* writer finished or either side failed */
     int res;
-    int blocks;
+};
 
-    while (total_blk) {
-        if (total_blk - xfer_blk > 0)
-            blocks = xfer_blk;
-        else
-            blocks = total_blk;
+static void *wr_writer_run(void *arg)
+{
+    struct wr_pipe *p = arg;
+    struct io_worker *w = &p->writer;
+    struct wr_cursor cur;
+    int64_t lba, blocks;
+    int start_time = time((time_t *)NULL);
+    int stop, res = 0;
+
+    wr_cursor_init(w, &cur);
+    while ((blocks = wr_next_group(w, &cur, &lba))) {
+        pthread_mutex_lock(&p->lock);
+        while (!p->stop && ((p->written - p->verified) >= write_ahead))
+            pthread_cond_wait(&p->cond, &p->lock);
+        stop = p->stop;
+        pthread_mutex_unlock(&p->lock);
+        if (stop)
+            break;
 
-        memset(buff, 0, (xfer_blk*sect_sz));
-        res = scsi_read(fd, buff, blocks, start_lba, sect_sz);
-        if (res == SG_LIB_CAT_UNIT_ATTENTION)
-            res = scsi_read(fd, buff, blocks, start_lba, sect_sz); /* retry */
+        res = xfer_blocks(w, 1, p->wrPos, 0, lba, blocks,
+                          w->xfer_sz/sect_sz, NULL);
+        if (res && log_fp)
+            fprintf(log_fp, "error: scsi_write() res=0x%x lba=0x%"PRIx64"\n",
+                    res, lba);
 
+        pthread_mutex_lock(&p->lock);
+        if (res) {
+            p->res = res;
+            p->stop = 1;
+        } else
+            p->written++;
+        pthread_cond_broadcast(&p->cond);
+        pthread_mutex_unlock(&p->lock);
         if (res)
             break;
 
-        if (memcmp(buff, data, (blocks*sect_sz))) {
-            fprintf(stderr, "ERROR: data compare error, start LBA %"PRId64"\n", start_lba);
-            res = -1;
+        if ((-1 != w->duration) &&
+            (time((time_t *)NULL) > (start_time + w->duration)))
             break;
-        }
+    }
 
-        total_blk -= blocks;
-        start_lba += blocks;
+    pthread_mutex_lock(&p->lock);
+    p->stop = 1;
+    pthread_cond_broadcast(&p->cond);
+    pthread_mutex_unlock(&p->lock);
+    return NULL;
+}
+
+/* Writes run up to 'write_ahead' groups in front of the verify, in
+ * another thread, so that the drive streams writes while the previous
+ * groups are read back and compared. Every group written is verified. */
+static int wr_pipelined(struct io_worker *w, void *wrPos, void *rdPos)
+{
+    struct wr_pipe p;
+    struct wr_cursor cur;
+    pthread_t writer;
+    int64_t lba, blocks;
+    int res = 0;
+
+    memset(&p, 0, sizeof(p));
+    p.writer = *w;
+    p.wrPos = wrPos;
+    p.writer.fd = open_dev(w->path, verbose);
+    if (p.writer.fd < 0) {
+        fprintf(stderr, "Can not open device: %s\n", w->path);
+        return -1;
+    }
+    p.writer.depth = probe_depth(p.writer.fd);
+    pthread_mutex_init(&p.lock, NULL);
+    pthread_cond_init(&p.cond, NULL);
+
+    if (pthread_create(&writer, NULL, wr_writer_run, &p)) {
+        fprintf(stderr, "pthread_create: %s\n", strerror(errno));
+        res = -1;
+        goto out;
     }
 
+    wr_cursor_init(w, &cur);
+    for (;;) {
+        pthread_mutex_lock(&p.lock);
+        while (!p.stop && (p.verified == p.written))
+            pthread_cond_wait(&p.cond, &p.lock);
+        if (p.verified == p.written) {
+            pthread_mutex_unlock(&p.lock);
+            break;
+        }
+        pthread_mutex_unlock(&p.lock);
+
+        blocks = wr_next_group(w, &cur, &lba);
+        res = xfer_blocks(w, 0, rdPos, w->xfer_sz, lba, blocks,
+                          w->xfer_sz/sect_sz, wrPos);
+        if (res && log_fp)
+            fprintf(log_fp, "error: scsi_read() res=0x%x lba=0x%"PRIx64"\n",
+                    res, lba);
+
+        pthread_mutex_lock(&p.lock);
+        p.verified++;
+        if (res)
+            p.stop = 1;
+        pthread_cond_broadcast(&p.cond);
+        pthread_mutex_unlock(&p.lock);
+        if (res)
+            break;
+    }
+    pthread_join(writer, NULL);
+    if (!res)
+        res = p.res;
+out:
+    close(p.writer.fd);
+    pthread_cond_destroy(&p.cond);
+    pthread_mutex_destroy(&p.lock);
     return res;
 }
 
-static int write_read_op(int fd, int64_t start_lba,
-        int64_t test_sz, int xfer_sz, int iter, int duration)
+static int write_read_op(struct io_worker *w)
 {
-    int res, i;
+    int res = 0;
     void *wrBuff;
     void *wrPos;
     void *rdBuff;
     void *rdPos;
-    int64_t total_blk;
+    struct wr_cursor cur;
     int64_t xfer_blk;
-    int seed;
     int start_time;
     int current_time;
 
 	int64_t ptr_lba;
-	int blocks;
+	int64_t blocks;
 
-    wrBuff = malloc(xfer_sz + sysconf(_SC_PAGESIZE));
+    wrBuff = malloc(w->xfer_sz + sysconf(_SC_PAGESIZE));
     if (wrBuff == NULL) {
         fprintf(stderr, "Not enough user memory\n");
         return -1;
@@ -672,7 +1016,7 @@ static int write_read_op(int fd, int64_t start_lba,
     wrPos = (void*) (((unsigned long)wrBuff + sysconf(_SC_PAGESIZE) - 1)
             & (~(sysconf(_SC_PAGESIZE) - 1)));
 
-    rdBuff = malloc(xfer_sz + sysconf(_SC_PAGESIZE));
+    rdBuff = malloc(w->xfer_sz * w->depth + sysconf(_SC_PAGESIZE));
     if (rdBuff == NULL) {
         fprintf(stderr, "Not enough user memory\n");
         free(wrBuff);
@@ -682,55 +1026,41 @@ static int write_read_op(int fd, int64_t start_lba,
             & (~(sysconf(_SC_PAGESIZE) - 1)));
 
     /* fill in test pattern */
-    seed = time(NULL);
-    srand(seed);
-    for (i = 0; i < (xfer_sz/4); i++) {
-        if (use_random_pattern)
-            *(((int*)wrPos) + i) = rand(); 
-        else
-            *(((int*)wrPos) + i) = user_pattern;
-    }
-
-	start_time = time((time_t *)NULL);
-
-	if (iter == 0)
-        	iter = UINT_MAX;
-
+    fill_pattern(wrPos, w->xfer_sz, time(NULL) + w->id);
 
-	while (iter) {
-		ptr_lba = start_lba;
-		total_blk = test_sz/sect_sz;
-		xfer_blk = xfer_sz/sect_sz;
+	if (write_ahead > 0) {
+		res = wr_pipelined(w, wrPos, rdPos);
+		goto error_out;
+	}
 
-		while(total_blk) {       
- 			if (total_blk - xfer_blk > 0)
-				blocks = xfer_blk;
-			else
-				blocks = total_blk;
+	start_time = time((time_t *)NULL);
+	xfer_blk = w->xfer_sz/sect_sz;
+
+	/* 'depth' transfers are written, then read back */
+	wr_cursor_init(w, &cur);
+	while ((blocks = wr_next_group(w, &cur, &ptr_lba))) {
+	        res = xfer_blocks(w, 1, wrPos, 0, ptr_lba, blocks, xfer_blk,
+				  NULL);
+	        if (res) {
+			if (log_fp)
+	        		fprintf(log_fp, "error: scsi_write() res=0x%x lba=0x%"PRIx64"\n", res, ptr_lba);
+			goto error_out;
+		}
 
-	        	res = __write_op(fd, wrPos, ptr_lba, blocks, xfer_blk);
-		        if (res) {
-	        		fprintf(log_fp, "error: scsi_write() res=0x%x lba=0x%x\n", res, ptr_lba);
-				goto error_out;
-			}
+	        res = xfer_blocks(w, 0, rdPos, w->xfer_sz, ptr_lba, blocks,
+				  xfer_blk, wrPos);
+	        if (res) {
+			if (log_fp)
+	        		fprintf(log_fp, "error: scsi_read() res=0x%x lba=0x%"PRIx64"\n", res, ptr_lba);
+			goto error_out;
+		}
 
-		        res = read_and_compare(fd, rdPos, ptr_lba, blocks, xfer_blk, wrPos);
-		        if (res) {
-	        		fprintf(log_fp, "error: scsi_read() res=0x%x lba=0x%x\n", res, ptr_lba);
+		if(-1 != w->duration) {
+			current_time = time((time_t *) NULL);
+			if(current_time > (start_time + w->duration)) {
 				goto error_out;
 			}
-
-			ptr_lba += xfer_blk;
-			total_blk -= xfer_blk;
-	
-			if(-1 != duration) {
-				current_time = time((time_t *) NULL);
-				if(current_time > (start_time + duration)) {
-					goto error_out;
-				}
-			}	
-		}
-	iter--;
+		}	
 	}
 
 error_out:
@@ -740,6 +1070,116 @@ error_out:
     return res;
 }
 
+static void *worker_run(void *arg)
+{
+    struct io_worker *w = arg;
+
+    switch (w->mode) {
+    case READ_OP:
+        w->res = read_op(w);
+        break;
+    case WRITE_OP:
+        w->res = write_op(w);
+        break;
+    case WRITE_READ_OP:
+        w->res = write_read_op(w);
+        break;
+    default:
+        break;
+    }
+    return NULL;
+}
+
+/* Splits the test range into 'num_threads' slices of whole transfers,
+ * each walked by a worker on its own file descriptor ('fd' for the
+ * first). Returns the first error of the workers, else 0. */
+static int run_workers(const char *path, int fd, int mode, int64_t start_lba,
+        int64_t test_sz, int xfer_sz, int iter, int duration)
+{
+    struct io_worker *workers, *w;
+    int64_t chunks, share, total_blk;
+    int k, n, xfer_blk;
+    int res = 0;
+
+    total_blk = test_sz/sect_sz;
+    xfer_blk = xfer_sz/sect_sz;
+    if (xfer_blk < 1) {
+        fprintf(stderr, "transfer size below block size (%d)\n", sect_sz);
+        return -1;
+    }
+    chunks = (total_blk + xfer_blk - 1) / xfer_blk;
+    n = (chunks < num_threads) ? (int)chunks : num_threads;
+    if (n < 1)
+        n = 1;
+    share = chunks / n;
+
+    workers = calloc(n, sizeof(*workers));
+    if (workers == NULL) {
+        fprintf(stderr, "Not enough user memory\n");
+        return -1;
+    }
+    for (k = 0; k < n; k++) {
+        w = &workers[k];
+        w->id = k;
+        w->mode = mode;
+        w->path = path;
+        w->xfer_sz = xfer_sz;
+        w->iter = iter;
+        w->duration = duration;
+        w->start_lba = start_lba + k * share * xfer_blk;
+        w->total_blk = (k == n - 1) ? (total_blk - k * share * xfer_blk) :
+                                      (share * xfer_blk);
+        w->fd = k ? open_dev(path, verbose) : fd;
+        if (w->fd < 0) {
+            fprintf(stderr, "Can not open device: %s\n", path);
+            n = k;
+            res = -1;
+            goto out;
+        }
+        w->depth = probe_depth(w->fd);
+    }
+    if ((queue_depth > 1) && (workers[0].depth == 1))
+        fprintf(stderr, "queue depth needs an sg device node, using 1\n");
+    if (verbose)
+        fprintf(stderr, "%d thread(s), queue depth %d\n", n,
+                workers[0].depth);
+
+    if (do_time) {
+        start_tm.tv_sec = 0;
+        start_tm.tv_usec = 0;
+        gettimeofday(&start_tm, NULL);
+        start_tm_valid = 1;
+    }
+
+    if (n == 1)
+        worker_run(&workers[0]);
+    else {
+        for (k = 0; k < n; k++) {
+            if (pthread_create(&workers[k].thread, NULL, worker_run,
+                               &workers[k])) {
+                fprintf(stderr, "pthread_create: %s\n", strerror(errno));
+                workers[k].res = -1;
+                break;
+            }
+        }
+        while (k--)
+            pthread_join(workers[k].thread, NULL);
+    }
+
+    if (do_time)
+        calc_duration_throughput(0);
+
+    for (k = 0; k < n; k++) {
+        if (workers[k].res && !res)
+            res = workers[k].res;
+    }
+out:
+    for (k = 1; k < n; k++)
+        close(workers[k].fd);
+    free(workers);
+    return res;
+}
+
 int main(int argc, char **argv)
 {
     int i, res;
@@ -826,6 +1266,24 @@ int main(int argc, char **argv)
             strncpy(log_path, buf, sizeof(log_path));
         } else if (!strcmp(key, "debug")) {
             verbose = sg_get_llnum(buf);
+        } else if (!strcmp(key, "-j")) {
+            num_threads = sg_get_num(buf);
+            if ((num_threads < 1) || (num_threads > MAX_THREADS)) {
+                fprintf(stderr, "bad argument\n");
+                return -1;
+            }
+        } else if (!strcmp(key, "-q")) {
+            queue_depth = sg_get_num(buf);
+            if ((queue_depth < 1) || (queue_depth > SG_MAX_QUEUE)) {
+                fprintf(stderr, "bad argument\n");
+                return -1;
+            }
+        } else if (!strcmp(key, "-a")) {
+            write_ahead = sg_get_num(buf);
+            if (-1 == write_ahead) {
+                fprintf(stderr, "bad argument\n");
+                return -1;
+            }
         } else if (!strcmp(key, "-d")) {
             duration = sg_get_num(buf);
             if (-1 == duration) {
@@ -861,22 +1319,8 @@ int main(int argc, char **argv)
         fprintf(stderr, "Test range: %lld bytes\n", test_sz);
 
 
-    switch (mode) {
-    case READ_OP:
-
-        res = read_op(fd, lba, test_sz, xfer_sz, iter, duration);
-        break;
-    case WRITE_OP:
-
-        res = write_op(fd, lba, test_sz, xfer_sz, iter, duration);
-        break;
-    case WRITE_READ_OP:
-
-        res = write_read_op(fd, lba, test_sz, xfer_sz, iter, duration);
-        break;
-    default:
-        break;
-    }
+    res = run_workers(dev_path, fd, mode, lba, test_sz, xfer_sz, iter,
+                      duration);
 
     close(fd);
 
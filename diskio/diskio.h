@@ -9,6 +9,9 @@
 
 #define DEFAULT_ITERATIONS    1
 #define DEFAULT_XFER_SIZE    512
+#define DEFAULT_THREADS    1
+#define DEFAULT_QUEUE_DEPTH    1
+#define MAX_THREADS    256
 
 #define STR_SZ    1024
 
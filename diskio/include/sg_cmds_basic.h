@@ -12,6 +12,31 @@
 extern "C" {
 #endif
 
+struct sg_pt_base;
+
+#define SG_CMDS_CTX_CDB_LEN 16
+#define SG_CMDS_CTX_SENSE_LEN 64
+
+/* A reusable pass-through context: the pass-through object plus storage
+ * for the cdb and sense data of one command. Issuing commands through
+ * the sg_ll_*_ctx() functions with one context per thread avoids the
+ * allocation (and free) of a pass-through object for every command.
+ * A context must not be used by two threads at the same time. */
+struct sg_cmds_ctx {
+    struct sg_pt_base * ptvp;
+    unsigned char cdb[SG_CMDS_CTX_CDB_LEN];
+    unsigned char sense_b[SG_CMDS_CTX_SENSE_LEN];
+};
+
+/* Returns a new context, NULL if out of memory */
+extern struct sg_cmds_ctx * sg_cmds_construct_ctx(void);
+
+extern void sg_cmds_destruct_ctx(struct sg_cmds_ctx * ctxp);
+
+/* Readies the context for the next command, no allocation is done. The
+ * sg_ll_*_ctx() functions call this before building their cdb. */
+extern void sg_cmds_reset_ctx(struct sg_cmds_ctx * ctxp);
+
 
 /* Invokes a SCSI INQUIRY command and yields the response
  * Returns 0 when successful, SG_LIB_CAT_INVALID_OP -> not supported,
@@ -138,6 +163,12 @@ extern int sg_ll_sync_cache_10(int sg_fd, int sync_nv, int immed, int group,
                                unsigned int lba, unsigned int count,
                                int noisy, int verbose);
 
+/* As sg_ll_sync_cache_10() but uses the given context */
+extern int sg_ll_sync_cache_10_ctx(struct sg_cmds_ctx * ctxp, int sg_fd,
+                                   int sync_nv, int immed, int group,
+                                   unsigned int lba, unsigned int count,
+                                   int noisy, int verbose);
+
 /* Invokes a SCSI TEST UNIT READY command.
  * 'pack_id' is just for diagnostics, safe to set to 0.
  * Return of 0 -> success, SG_LIB_CAT_UNIT_ATTENTION,
@@ -157,6 +188,11 @@ extern int sg_ll_test_unit_ready_progress(int sg_fd, int pack_id,
                                           int * progress, int noisy,
                                           int verbose);
 
+/* As sg_ll_test_unit_ready_progress() but uses the given context */
+extern int sg_ll_test_unit_ready_ctx(struct sg_cmds_ctx * ctxp, int sg_fd,
+                                     int pack_id, int * progress, int noisy,
+                                     int verbose);
+
 
 struct sg_simple_inquiry_resp {
     unsigned char peripheral_qualifier;
@@ -210,6 +210,11 @@ extern int sg_ll_unmap_v2(int sg_fd, int anchor, int group_num,
                           int timeout_secs, void * paramp, int param_len,
                           int noisy, int verbose);
 
+/* As sg_ll_unmap_v2() but uses the given context, see sg_cmds_basic.h */
+extern int sg_ll_unmap_ctx(struct sg_cmds_ctx * ctxp, int sg_fd, int anchor,
+                           int group_num, int timeout_secs, void * paramp,
+                           int param_len, int noisy, int verbose);
+
 /* Invokes a SCSI VERIFY (10) command (SBC and MMC).
  * Note that 'veri_len' is in blocks while 'data_out_len' is in bytes.
  * Returns of 0 -> success,
@@ -224,6 +229,13 @@ extern int sg_ll_verify10(int sg_fd, int vrprotect, int dpo, int bytechk,
                           int data_out_len, unsigned int * infop, int noisy,
                           int verbose);
 
+/* As sg_ll_verify10() but uses the given context, see sg_cmds_basic.h */
+extern int sg_ll_verify10_ctx(struct sg_cmds_ctx * ctxp, int sg_fd,
+                              int vrprotect, int dpo, int bytechk,
+                              unsigned int lba, int veri_len,
+                              void * data_out, int data_out_len,
+                              unsigned int * infop, int noisy, int verbose);
+
 /* Invokes a SCSI VERIFY (16) command (SBC).
  * Note that 'veri_len' is in blocks while 'data_out_len' is in bytes.
  * Returns of 0 -> success,
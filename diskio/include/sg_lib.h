@@ -173,6 +173,13 @@ extern char * sg_get_sense_key_str(int sense_key, int buff_len, char * buff);
 extern char * sg_get_asc_ascq_str(int asc, int ascq, int buff_len,
                                   char * buff);
 
+/* Yields "<sense key>, <additional sense>" of the sense data into 'buff'
+ * in one pass, no more than 'buff_len' bytes (including the trailing
+ * null). Cheaper than sg_get_sense_str() for per command logging.
+ * Returns the number of characters written (excluding the null). */
+extern int sg_get_sense_brief_str(const unsigned char * sensep, int sb_len,
+                                  int buff_len, char * buff);
+
 /* Returns 1 if valid bit set, 0 if valid bit clear. Irrespective the
  * information field is written out via 'info_outp' (except when it is
  * NULL). Handles both fixed and descriptor sense formats. */
@@ -78,6 +78,21 @@ extern struct sg_lib_value_name_t sg_lib_rec_copy_sa_arr[];
 extern struct sg_lib_value_name_t sg_lib_variable_length_arr[];
 extern struct sg_lib_asc_ascq_range_t sg_lib_asc_ascq_range[];
 extern struct sg_lib_asc_ascq_t sg_lib_asc_ascq[];
+
+/* Lookup indexes over the tables above, generated at build time into
+ * sg_lib_data_idx.c by sg_lib_idx_gen . Element n of an ASCQ sub-table:
+ * n > 0 -> sg_lib_asc_ascq[n - 1], n < 0 -> sg_lib_asc_ascq_range[-n - 1],
+ * 0 -> no entry. */
+struct sg_lib_asc_idx_t {
+    const short * ascq;         /* sub-table indexed by ASCQ */
+    int num;                    /* number of ASCQs in sub-table */
+};
+
+extern const struct sg_lib_asc_idx_t sg_lib_asc_idx[];
+
+/* Element n > 0 -> sg_lib_normal_opcodes[n - 1] is the first entry of that
+ * opcode, 0 -> opcode not in table */
+extern const short sg_lib_normal_opcodes_idx[];
 extern const char * sg_lib_sense_key_desc[];
 extern const char * sg_lib_pdt_strs[];
 extern const char * sg_lib_transport_proto_strs[];
@@ -373,6 +373,43 @@ sg_simple_inquiry(int sg_fd, struct sg_simple_inquiry_resp * inq_data,
     return ret;
 }
 
+/* Returns a pass-through context for the sg_ll_*_ctx() functions, or
+ * NULL if out of memory. */
+struct sg_cmds_ctx *
+sg_cmds_construct_ctx(void)
+{
+    struct sg_cmds_ctx * ctxp;
+
+    ctxp = (struct sg_cmds_ctx *)calloc(1, sizeof(struct sg_cmds_ctx));
+    if (NULL == ctxp)
+        return NULL;
+    ctxp->ptvp = construct_scsi_pt_obj();
+    if (NULL == ctxp->ptvp) {
+        free(ctxp);
+        return NULL;
+    }
+    return ctxp;
+}
+
+void
+sg_cmds_destruct_ctx(struct sg_cmds_ctx * ctxp)
+{
+    if (ctxp) {
+        if (ctxp->ptvp)
+            destruct_scsi_pt_obj(ctxp->ptvp);
+        free(ctxp);
+    }
+}
+
+/* Readies the context for the next command without any allocation. The
+ * sense buffer is cleared when it is attached to the next command. */
+void
+sg_cmds_reset_ctx(struct sg_cmds_ctx * ctxp)
+{
+    clear_scsi_pt_obj(ctxp->ptvp);
+    memset(ctxp->cdb, 0, sizeof(ctxp->cdb));
+}
+
 /* Invokes a SCSI TEST UNIT READY command.
  * 'pack_id' is just for diagnostics, safe to set to 0.
  * Looks for progress indicator if 'progress' non-NULL;
@@ -383,12 +420,35 @@ sg_simple_inquiry(int sg_fd, struct sg_simple_inquiry_resp * inq_data,
 int
 sg_ll_test_unit_ready_progress(int sg_fd, int pack_id, int * progress,
                                int noisy, int verbose)
+{
+    struct sg_cmds_ctx ctx;
+    int ret;
+
+    if (NULL == sg_warnings_strm)
+        sg_warnings_strm = stderr;
+    ctx.ptvp = construct_scsi_pt_obj();
+    if (NULL == ctx.ptvp) {
+        fprintf(sg_warnings_strm, "test unit ready: out of memory\n");
+        return -1;
+    }
+    ret = sg_ll_test_unit_ready_ctx(&ctx, sg_fd, pack_id, progress, noisy,
+                                    verbose);
+    destruct_scsi_pt_obj(ctx.ptvp);
+    return ret;
+}
+
+/* As sg_ll_test_unit_ready_progress() but uses the given context */
+int
+sg_ll_test_unit_ready_ctx(struct sg_cmds_ctx * ctxp, int sg_fd, int pack_id,
+                          int * progress, int noisy, int verbose)
 {
     int res, ret, k, sense_cat;
-    unsigned char turCmdBlk[TUR_CMDLEN] = {TUR_CMD, 0, 0, 0, 0, 0};
-    unsigned char sense_b[SENSE_BUFF_LEN];
-    struct sg_pt_base * ptvp;
+    unsigned char * turCmdBlk = ctxp->cdb;
+    unsigned char * sense_b = ctxp->sense_b;
+    struct sg_pt_base * ptvp = ctxp->ptvp;
 
+    sg_cmds_reset_ctx(ctxp);
+    turCmdBlk[0] = TUR_CMD;
     if (NULL == sg_warnings_strm)
         sg_warnings_strm = stderr;
     if (verbose) {
@@ -398,13 +458,8 @@ sg_ll_test_unit_ready_progress(int sg_fd, int pack_id, int * progress,
         fprintf(sg_warnings_strm, "\n");
     }
 
-    ptvp = construct_scsi_pt_obj();
-    if (NULL == ptvp) {
-        fprintf(sg_warnings_strm, "test unit ready: out of memory\n");
-        return -1;
-    }
-    set_scsi_pt_cdb(ptvp, turCmdBlk, sizeof(turCmdBlk));
-    set_scsi_pt_sense(ptvp, sense_b, sizeof(sense_b));
+    set_scsi_pt_cdb(ptvp, turCmdBlk, TUR_CMDLEN);
+    set_scsi_pt_sense(ptvp, sense_b, SG_CMDS_CTX_SENSE_LEN);
     set_scsi_pt_packet_id(ptvp, pack_id);
     res = do_scsi_pt(ptvp, sg_fd, DEF_PT_TIMEOUT, verbose);
     ret = sg_cmds_process_resp(ptvp, "test unit ready", res, 0, sense_b,
@@ -437,7 +492,6 @@ sg_ll_test_unit_ready_progress(int sg_fd, int pack_id, int * progress,
     } else
         ret = 0;
 
-    destruct_scsi_pt_obj(ptvp);
     return ret;
 }
 
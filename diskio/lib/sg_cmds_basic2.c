@@ -75,13 +75,36 @@ int
 sg_ll_sync_cache_10(int sg_fd, int sync_nv, int immed, int group,
                     unsigned int lba, unsigned int count, int noisy,
                     int verbose)
+{
+    struct sg_cmds_ctx ctx;
+    int ret;
+
+    if (NULL == sg_warnings_strm)
+        sg_warnings_strm = stderr;
+    ctx.ptvp = construct_scsi_pt_obj();
+    if (NULL == ctx.ptvp) {
+        fprintf(sg_warnings_strm, "synchronize cache(10): out of memory\n");
+        return -1;
+    }
+    ret = sg_ll_sync_cache_10_ctx(&ctx, sg_fd, sync_nv, immed, group, lba,
+                                  count, noisy, verbose);
+    destruct_scsi_pt_obj(ctx.ptvp);
+    return ret;
+}
+
+/* As sg_ll_sync_cache_10() but uses the given context */
+int
+sg_ll_sync_cache_10_ctx(struct sg_cmds_ctx * ctxp, int sg_fd, int sync_nv,
+                        int immed, int group, unsigned int lba,
+                        unsigned int count, int noisy, int verbose)
 {
     int res, ret, k, sense_cat;
-    unsigned char scCmdBlk[SYNCHRONIZE_CACHE_CMDLEN] =
-                {SYNCHRONIZE_CACHE_CMD, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-    unsigned char sense_b[SENSE_BUFF_LEN];
-    struct sg_pt_base * ptvp;
+    unsigned char * scCmdBlk = ctxp->cdb;
+    unsigned char * sense_b = ctxp->sense_b;
+    struct sg_pt_base * ptvp = ctxp->ptvp;
 
+    sg_cmds_reset_ctx(ctxp);
+    scCmdBlk[0] = SYNCHRONIZE_CACHE_CMD;
     if (sync_nv)
         scCmdBlk[1] |= 4;
     if (immed)
@@ -106,13 +129,8 @@ sg_ll_sync_cache_10(int sg_fd, int sync_nv, int immed, int group,
             fprintf(sg_warnings_strm, "%02x ", scCmdBlk[k]);
         fprintf(sg_warnings_strm, "\n");
     }
-    ptvp = construct_scsi_pt_obj();
-    if (NULL == ptvp) {
-        fprintf(sg_warnings_strm, "synchronize cache(10): out of memory\n");
-        return -1;
-    }
-    set_scsi_pt_cdb(ptvp, scCmdBlk, sizeof(scCmdBlk));
-    set_scsi_pt_sense(ptvp, sense_b, sizeof(sense_b));
+    set_scsi_pt_cdb(ptvp, scCmdBlk, SYNCHRONIZE_CACHE_CMDLEN);
+    set_scsi_pt_sense(ptvp, sense_b, SG_CMDS_CTX_SENSE_LEN);
     res = do_scsi_pt(ptvp, sg_fd, DEF_PT_TIMEOUT, verbose);
     ret = sg_cmds_process_resp(ptvp, "synchronize cache(10)", res, 0,
                                sense_b, noisy, verbose, &sense_cat);
@@ -138,7 +156,6 @@ sg_ll_sync_cache_10(int sg_fd, int sync_nv, int immed, int group,
     } else
         ret = 0;
 
-    destruct_scsi_pt_obj(ptvp);
     return ret;
 }
 
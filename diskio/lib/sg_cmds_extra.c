@@ -1572,13 +1572,38 @@ sg_ll_verify10(int sg_fd, int vrprotect, int dpo, int bytchk,
                unsigned int lba, int veri_len, void * data_out,
                int data_out_len, unsigned int * infop, int noisy,
                int verbose)
+{
+    struct sg_cmds_ctx ctx;
+    int ret;
+
+    if (NULL == sg_warnings_strm)
+        sg_warnings_strm = stderr;
+    ctx.ptvp = construct_scsi_pt_obj();
+    if (NULL == ctx.ptvp) {
+        fprintf(sg_warnings_strm, "verify (10): out of memory\n");
+        return -1;
+    }
+    ret = sg_ll_verify10_ctx(&ctx, sg_fd, vrprotect, dpo, bytchk, lba,
+                             veri_len, data_out, data_out_len, infop, noisy,
+                             verbose);
+    destruct_scsi_pt_obj(ctx.ptvp);
+    return ret;
+}
+
+/* As sg_ll_verify10() but uses the given context */
+int
+sg_ll_verify10_ctx(struct sg_cmds_ctx * ctxp, int sg_fd, int vrprotect,
+                   int dpo, int bytchk, unsigned int lba, int veri_len,
+                   void * data_out, int data_out_len, unsigned int * infop,
+                   int noisy, int verbose)
 {
     int k, res, ret, sense_cat;
-    unsigned char vCmdBlk[VERIFY10_CMDLEN] =
-                {VERIFY10_CMD, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-    unsigned char sense_b[SENSE_BUFF_LEN];
-    struct sg_pt_base * ptvp;
+    unsigned char * vCmdBlk = ctxp->cdb;
+    unsigned char * sense_b = ctxp->sense_b;
+    struct sg_pt_base * ptvp = ctxp->ptvp;
 
+    sg_cmds_reset_ctx(ctxp);
+    vCmdBlk[0] = VERIFY10_CMD;
     /* N.B. BYTCHK field expanded to 2 bits sbc3r34 */
     vCmdBlk[1] = ((vrprotect & 0x7) << 5) | ((dpo & 0x1) << 4) |
                  ((bytchk & 0x3) << 1) ;
@@ -1602,13 +1627,8 @@ sg_ll_verify10(int sg_fd, int vrprotect, int dpo, int bytchk,
             dStrHex((const char *)data_out, k, verbose < 5);
         }
     }
-    ptvp = construct_scsi_pt_obj();
-    if (NULL == ptvp) {
-        fprintf(sg_warnings_strm, "verify (10): out of memory\n");
-        return -1;
-    }
-    set_scsi_pt_cdb(ptvp, vCmdBlk, sizeof(vCmdBlk));
-    set_scsi_pt_sense(ptvp, sense_b, sizeof(sense_b));
+    set_scsi_pt_cdb(ptvp, vCmdBlk, VERIFY10_CMDLEN);
+    set_scsi_pt_sense(ptvp, sense_b, SG_CMDS_CTX_SENSE_LEN);
     if (data_out_len > 0)
         set_scsi_pt_data_out(ptvp, (unsigned char *)data_out, data_out_len);
     res = do_scsi_pt(ptvp, sg_fd, DEF_PT_TIMEOUT, verbose);
@@ -1651,7 +1671,6 @@ sg_ll_verify10(int sg_fd, int vrprotect, int dpo, int bytchk,
     } else
         ret = 0;
 
-    destruct_scsi_pt_obj(ptvp);
     return ret;
 }
 
@@ -2085,13 +2104,36 @@ sg_ll_unmap(int sg_fd, int group_num, int timeout_secs, void * paramp,
 int
 sg_ll_unmap_v2(int sg_fd, int anchor, int group_num, int timeout_secs,
                void * paramp, int param_len, int noisy, int verbose)
+{
+    struct sg_cmds_ctx ctx;
+    int ret;
+
+    if (NULL == sg_warnings_strm)
+        sg_warnings_strm = stderr;
+    ctx.ptvp = construct_scsi_pt_obj();
+    if (NULL == ctx.ptvp) {
+        fprintf(sg_warnings_strm, "unmap: out of memory\n");
+        return -1;
+    }
+    ret = sg_ll_unmap_ctx(&ctx, sg_fd, anchor, group_num, timeout_secs,
+                          paramp, param_len, noisy, verbose);
+    destruct_scsi_pt_obj(ctx.ptvp);
+    return ret;
+}
+
+/* As sg_ll_unmap_v2() but uses the given context */
+int
+sg_ll_unmap_ctx(struct sg_cmds_ctx * ctxp, int sg_fd, int anchor,
+                int group_num, int timeout_secs, void * paramp,
+                int param_len, int noisy, int verbose)
 {
     int k, res, ret, sense_cat, tmout;
-    unsigned char uCmdBlk[UNMAP_CMDLEN] =
-                         {UNMAP_CMD, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-    unsigned char sense_b[SENSE_BUFF_LEN];
-    struct sg_pt_base * ptvp;
+    unsigned char * uCmdBlk = ctxp->cdb;
+    unsigned char * sense_b = ctxp->sense_b;
+    struct sg_pt_base * ptvp = ctxp->ptvp;
 
+    sg_cmds_reset_ctx(ctxp);
+    uCmdBlk[0] = UNMAP_CMD;
     if (anchor)
         uCmdBlk[1] |= 0x1;
     tmout = (timeout_secs > 0) ? timeout_secs : DEF_PT_TIMEOUT;
@@ -2111,13 +2153,8 @@ sg_ll_unmap_v2(int sg_fd, int anchor, int group_num, int timeout_secs,
         }
     }
 
-    ptvp = construct_scsi_pt_obj();
-    if (NULL == ptvp) {
-        fprintf(sg_warnings_strm, "unmap: out of memory\n");
-        return -1;
-    }
-    set_scsi_pt_cdb(ptvp, uCmdBlk, sizeof(uCmdBlk));
-    set_scsi_pt_sense(ptvp, sense_b, sizeof(sense_b));
+    set_scsi_pt_cdb(ptvp, uCmdBlk, UNMAP_CMDLEN);
+    set_scsi_pt_sense(ptvp, sense_b, SG_CMDS_CTX_SENSE_LEN);
     set_scsi_pt_data_out(ptvp, (unsigned char *)paramp, param_len);
     res = do_scsi_pt(ptvp, sg_fd, tmout, verbose);
     ret = sg_cmds_process_resp(ptvp, "unmap", res, 0,
@@ -2142,7 +2179,6 @@ sg_ll_unmap_v2(int sg_fd, int anchor, int group_num, int timeout_secs,
         }
     } else
         ret = 0;
-    destruct_scsi_pt_obj(ptvp);
     return ret;
 }
 
@@ -51,6 +51,24 @@ FILE * sg_warnings_strm = NULL;        /* would like to default to stderr */
 static void dStrHexErr(const char* str, int len, int b_len, char * b);
 
 
+/* 'vp' is the first entry matching 'value', of the consecutive entries
+   with that 'value' prefers the one matching 'peri_type'. */
+static const struct sg_lib_value_name_t *
+pick_value_name(const struct sg_lib_value_name_t * vp, int value,
+                int peri_type)
+{
+    const struct sg_lib_value_name_t * holdp = vp;
+
+    if (peri_type == vp->peri_dev_type)
+        return vp;
+    while ((vp + 1)->name && (value == (vp + 1)->value)) {
+        ++vp;
+        if (peri_type == vp->peri_dev_type)
+            return vp;
+    }
+    return holdp;
+}
+
 /* Searches 'arr' for match on 'value' then 'peri_type'. If matches
    'value' but not 'peri_type' then yields first 'value' match entry.
    Last element of 'arr' has NULL 'name'. If no match returns NULL. */
@@ -59,24 +77,27 @@ get_value_name(const struct sg_lib_value_name_t * arr, int value,
                int peri_type)
 {
     const struct sg_lib_value_name_t * vp = arr;
-    const struct sg_lib_value_name_t * holdp;
 
     for (; vp->name; ++vp) {
-        if (value == vp->value) {
-            if (peri_type == vp->peri_dev_type)
-                return vp;
-            holdp = vp;
-            while ((vp + 1)->name && (value == (vp + 1)->value)) {
-                ++vp;
-                if (peri_type == vp->peri_dev_type)
-                    return vp;
-            }
-            return holdp;
-        }
+        if (value == vp->value)
+            return pick_value_name(vp, value, peri_type);
     }
     return NULL;
 }
 
+/* Appends 'src' at offset 'n' of 'buff' without overrunning 'buff_len'
+ * (which includes the trailing null). Returns the new offset. */
+static int
+append_str(char * buff, int n, int buff_len, const char * src)
+{
+    if (n >= buff_len)
+        return n;
+    while ((n < (buff_len - 1)) && *src)
+        buff[n++] = *src++;
+    buff[n] = '\0';
+    return n;
+}
+
 void
 sg_set_warnings_strm(FILE * warnings_strm)
 {
@@ -155,35 +176,23 @@ sg_get_sense_key_str(int sense_key, int buff_len, char * buff)
 char *
 sg_get_asc_ascq_str(int asc, int ascq, int buff_len, char * buff)
 {
-    int k, num, rlen;
-    int found = 0;
-    struct sg_lib_asc_ascq_t * eip;
-    struct sg_lib_asc_ascq_range_t * ei2p;
-
-    for (k = 0; sg_lib_asc_ascq_range[k].text; ++k) {
-        ei2p = &sg_lib_asc_ascq_range[k];
-        if ((ei2p->asc == asc) &&
-            (ascq >= ei2p->ascq_min)  &&
-            (ascq <= ei2p->ascq_max)) {
-            found = 1;
-            num = snprintf(buff, buff_len, "Additional sense: ");
-            rlen = buff_len - num;
-            num += snprintf(buff + num, ((rlen > 0) ? rlen : 0),
-                            ei2p->text, ascq);
-        }
-    }
-    if (found)
-        return buff;
-
-    for (k = 0; sg_lib_asc_ascq[k].text; ++k) {
-        eip = &sg_lib_asc_ascq[k];
-        if (eip->asc == asc &&
-            eip->ascq == ascq) {
-            found = 1;
-            snprintf(buff, buff_len, "Additional sense: %s", eip->text);
-        }
+    int num, rlen, n = 0;
+    const struct sg_lib_asc_idx_t * aip;
+
+    if ((asc >= 0) && (asc < 256)) {
+        aip = &sg_lib_asc_idx[asc];
+        if ((ascq >= 0) && (ascq < aip->num))
+            n = aip->ascq[ascq];
     }
-    if (! found) {
+    if (n < 0) {
+        num = append_str(buff, 0, buff_len, "Additional sense: ");
+        rlen = buff_len - num;
+        snprintf(buff + num, ((rlen > 0) ? rlen : 0),
+                 sg_lib_asc_ascq_range[-n - 1].text, ascq);
+    } else if (n > 0) {
+        num = append_str(buff, 0, buff_len, "Additional sense: ");
+        append_str(buff, num, buff_len, sg_lib_asc_ascq[n - 1].text);
+    } else {
         if (asc >= 0x80)
             snprintf(buff, buff_len, "vendor specific ASC=%02x, ASCQ=%02x "
                      "(hex)", asc, ascq);
@@ -196,6 +205,27 @@ sg_get_asc_ascq_str(int asc, int ascq, int buff_len, char * buff)
     return buff;
 }
 
+int
+sg_get_sense_brief_str(const unsigned char * sensep, int sb_len,
+                       int buff_len, char * buff)
+{
+    int n;
+    struct sg_scsi_sense_hdr ssh;
+
+    if ((NULL == buff) || (buff_len < 1))
+        return 0;
+    buff[0] = '\0';
+    if (! sg_scsi_normalize_sense(sensep, sb_len, &ssh))
+        return append_str(buff, 0, buff_len, "no valid sense data");
+    n = append_str(buff, 0, buff_len, sg_lib_sense_key_desc[ssh.sense_key]);
+    n = append_str(buff, n, buff_len, ", ");
+    if (n < (buff_len - 1)) {
+        sg_get_asc_ascq_str(ssh.asc, ssh.ascq, buff_len - n, buff + n);
+        n += strlen(buff + n);
+    }
+    return n;
+}
+
 const unsigned char *
 sg_scsi_sense_desc_find(const unsigned char * sensep, int sense_len,
                         int desc_type)
@@ -1247,7 +1277,7 @@ sg_get_opcode_name(unsigned char cmd_byte0, int peri_type, int buff_len,
                    char * buff)
 {
     const struct sg_lib_value_name_t * vnp;
-    int grp;
+    int grp, k;
 
     if ((NULL == buff) || (buff_len < 1))
         return;
@@ -1262,7 +1292,9 @@ sg_get_opcode_name(unsigned char cmd_byte0, int peri_type, int buff_len,
     case 2:
     case 4:
     case 5:
-        vnp = get_value_name(sg_lib_normal_opcodes, cmd_byte0, peri_type);
+        k = sg_lib_normal_opcodes_idx[cmd_byte0];
+        vnp = k ? pick_value_name(&sg_lib_normal_opcodes[k - 1], cmd_byte0,
+                                  peri_type) : NULL;
         if (vnp)
             strncpy(buff, vnp->name, buff_len);
         else
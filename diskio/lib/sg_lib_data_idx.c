@@ -0,0 +1,806 @@
+/*
+ * Generated by sg_lib_idx_gen from sg_lib_data.c, do not edit.
+ */
+
+#include <stdlib.h>
+
+#include "sg_lib.h"
+#include "sg_lib_data.h"
+
+static const short asc_00[] = {
+    1, 2, 3, 4, 5, 6, 7, 8, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 9, 10, 11, 12, 13, 14, 15,
+    16, 17, 18, 19, 20, 21, 22, 23, 24,
+};
+static const short asc_01[] = {
+    25,
+};
+static const short asc_02[] = {
+    26,
+};
+static const short asc_03[] = {
+    27, 28, 29,
+};
+static const short asc_04[] = {
+    30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41,
+    42, 43, 0, 0, 44, 45, 46, 47, 48, 49, 50, 51,
+    52, 53, 54, 55, 56,
+};
+static const short asc_05[] = {
+    57,
+};
+static const short asc_06[] = {
+    58,
+};
+static const short asc_07[] = {
+    59,
+};
+static const short asc_08[] = {
+    60, 61, 62, 63, 64,
+};
+static const short asc_09[] = {
+    65, 66, 67, 68, 69,
+};
+static const short asc_0a[] = {
+    70,
+};
+static const short asc_0b[] = {
+    71, 72, 73, 74, 75, 76, 77, 78, 79, 80,
+};
+static const short asc_0c[] = {
+    81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92,
+    93, 94, 95, 96,
+};
+static const short asc_0d[] = {
+    97, 98, 99, 100, 101, 102,
+};
+static const short asc_0e[] = {
+    103, 104, 105, 106,
+};
+static const short asc_10[] = {
+    107, 108, 109, 110, 111, 112,
+};
+static const short asc_11[] = {
+    113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124,
+    125, 126, 127, 128, 129, 130, 131, 132, 133,
+};
+static const short asc_12[] = {
+    134,
+};
+static const short asc_13[] = {
+    135,
+};
+static const short asc_14[] = {
+    136, 137, 138, 139, 140, 141, 142, 143,
+};
+static const short asc_15[] = {
+    144, 145, 146,
+};
+static const short asc_16[] = {
+    147, 148, 149, 150, 151,
+};
+static const short asc_17[] = {
+    152, 153, 154, 155, 156, 157, 158, 159, 160, 161,
+};
+static const short asc_18[] = {
+    162, 163, 164, 165, 166, 167, 168, 169, 170,
+};
+static const short asc_19[] = {
+    171, 172, 173, 174,
+};
+static const short asc_1a[] = {
+    175,
+};
+static const short asc_1b[] = {
+    176,
+};
+static const short asc_1c[] = {
+    177, 178, 179,
+};
+static const short asc_1d[] = {
+    180, 181,
+};
+static const short asc_1e[] = {
+    182,
+};
+static const short asc_1f[] = {
+    183,
+};
+static const short asc_20[] = {
+    184, 185, 186, 187, 188, 189, 190, 191, 192, 193, 194, 195,
+    196,
+};
+static const short asc_21[] = {
+    197, 198, 199, 200,
+};
+static const short asc_22[] = {
+    201,
+};
+static const short asc_23[] = {
+    202, 203, 204, 205, 206, 207, 208, 209, 210, 211, 212,
+};
+static const short asc_24[] = {
+    213, 214, 215, 216, 217, 218, 219, 220, 221,
+};
+static const short asc_25[] = {
+    222,
+};
+static const short asc_26[] = {
+    223, 224, 225, 226, 227, 228, 229, 230, 231, 232, 233, 234,
+    235, 236, 237, 238, 239, 240, 241,
+};
+static const short asc_27[] = {
+    242, 243, 244, 245, 246, 247, 248, 249,
+};
+static const short asc_28[] = {
+    250, 251, 252, 253,
+};
+static const short asc_29[] = {
+    254, 255, 256, 257, 258, 259, 260, 261,
+};
+static const short asc_2a[] = {
+    262, 263, 264, 265, 266, 267, 268, 269, 270, 271, 278, 279,
+    272, 273, 0, 0, 274, 275, 276, 277, 280, 281,
+};
+static const short asc_2b[] = {
+    282,
+};
+static const short asc_2c[] = {
+    283, 284, 285, 286, 287, 288, 289, 290, 291, 292, 293, 294,
+    295,
+};
+static const short asc_2d[] = {
+    296,
+};
+static const short asc_2e[] = {
+    297,
+};
+static const short asc_2f[] = {
+    298, 299, 300, 301,
+};
+static const short asc_30[] = {
+    302, 303, 304, 305, 306, 307, 308, 309, 310, 311, 312, 313,
+    314, 315, 0, 0, 316, 317, 318, 319,
+};
+static const short asc_31[] = {
+    320, 321, 322, 323,
+};
+static const short asc_32[] = {
+    324, 325,
+};
+static const short asc_33[] = {
+    326,
+};
+static const short asc_34[] = {
+    327,
+};
+static const short asc_35[] = {
+    328, 329, 330, 331, 332, 333,
+};
+static const short asc_36[] = {
+    334,
+};
+static const short asc_37[] = {
+    335,
+};
+static const short asc_38[] = {
+    336, 0, 337, 0, 338, 0, 339, 340,
+};
+static const short asc_39[] = {
+    341,
+};
+static const short asc_3a[] = {
+    342, 343, 344, 345, 346,
+};
+static const short asc_3b[] = {
+    347, 348, 349, 350, 351, 352, 353, 354, 355, 356, 357, 358,
+    359, 360, 361, 362, 0, 363, 364, 365, 366, 367, 368, 369,
+    370, 371, 372, 373, 374,
+};
+static const short asc_3d[] = {
+    375,
+};
+static const short asc_3e[] = {
+    376, 377, 378, 379, 380,
+};
+static const short asc_3f[] = {
+    381, 382, 383, 384, 385, 386, 387, 388, 389, 390, 391, 392,
+    393, 394, 395, 396, 397, 398, 399, 400, 401,
+};
+static const short asc_40[] = {
+    402, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -2, -2, -2, -2,
+    -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2,
+    -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2,
+    -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2,
+    -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2,
+    -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2,
+    -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2,
+    -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2,
+    -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2,
+    -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2,
+    -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2,
+    -2, -2, -2, -2,
+};
+static const short asc_41[] = {
+    403, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+    -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+    -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+    -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+    -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+    -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+    -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+    -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+    -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+    -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+    -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+    -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+    -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+    -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+    -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+    -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+    -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+    -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+    -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+    -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+    -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3,
+    -3, -3, -3, -3,
+};
+static const short asc_42[] = {
+    404, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4,
+};
+static const short asc_43[] = {
+    405,
+};
+static const short asc_44[] = {
+    406, 407, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 408,
+};
+static const short asc_45[] = {
+    409,
+};
+static const short asc_46[] = {
+    410,
+};
+static const short asc_47[] = {
+    411, 412, 413, 414, 415, 416, 417, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 418,
+};
+static const short asc_48[] = {
+    419,
+};
+static const short asc_49[] = {
+    420,
+};
+static const short asc_4a[] = {
+    421,
+};
+static const short asc_4b[] = {
+    422, 423, 424, 425, 426, 427, 428, 429, 430, 431, 432, 433,
+    434, 435,
+};
+static const short asc_4c[] = {
+    436,
+};
+static const short asc_4d[] = {
+    -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+    -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+    -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+    -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+    -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+    -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+    -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+    -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+    -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+    -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+    -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+    -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+    -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+    -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+    -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+    -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+    -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+    -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+    -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+    -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+    -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5, -5,
+    -5, -5, -5, -5,
+};
+static const short asc_4e[] = {
+    437,
+};
+static const short asc_50[] = {
+    438, 439, 440,
+};
+static const short asc_51[] = {
+    441, 442,
+};
+static const short asc_52[] = {
+    443,
+};
+static const short asc_53[] = {
+    444, 445, 446, 447, 448, 449, 450, 451, 452,
+};
+static const short asc_54[] = {
+    453,
+};
+static const short asc_55[] = {
+    454, 455, 456, 457, 458, 459, 460, 461, 462, 463, 464, 465,
+    466, 467,
+};
+static const short asc_57[] = {
+    468,
+};
+static const short asc_58[] = {
+    469,
+};
+static const short asc_59[] = {
+    470,
+};
+static const short asc_5a[] = {
+    471, 472, 473, 474,
+};
+static const short asc_5b[] = {
+    475, 476, 477, 478,
+};
+static const short asc_5c[] = {
+    479, 480, 481,
+};
+static const short asc_5d[] = {
+    482, 483, 484, 485, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 486, 487, 488, 489, 490, 491, 492, 493,
+    494, 495, 496, 497, 498, 0, 0, 0, 499, 500, 501, 502,
+    503, 504, 505, 506, 507, 508, 509, 510, 511, 0, 0, 0,
+    512, 513, 514, 515, 516, 517, 518, 519, 520, 521, 522, 523,
+    524, 0, 0, 0, 525, 526, 527, 528, 529, 530, 531, 532,
+    533, 534, 535, 536, 537, 0, 0, 0, 538, 539, 540, 541,
+    542, 543, 544, 545, 546, 547, 548, 549, 550, 0, 0, 0,
+    551, 552, 553, 554, 555, 556, 557, 558, 559, 560, 561, 562,
+    563, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 564,
+};
+static const short asc_5e[] = {
+    565, 566, 567, 568, 569, 570, 571, 572, 573, 574, 575, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 576, 577, 578, 0, 579, 0, 580,
+};
+static const short asc_60[] = {
+    581,
+};
+static const short asc_61[] = {
+    582, 583, 584,
+};
+static const short asc_62[] = {
+    585,
+};
+static const short asc_63[] = {
+    586, 587,
+};
+static const short asc_64[] = {
+    588, 589,
+};
+static const short asc_65[] = {
+    590,
+};
+static const short asc_66[] = {
+    591, 592, 593, 594,
+};
+static const short asc_67[] = {
+    595, 596, 597, 598, 599, 600, 601, 602, 603, 604, 605, 606,
+};
+static const short asc_68[] = {
+    607,
+};
+static const short asc_69[] = {
+    608, 609, 610,
+};
+static const short asc_6a[] = {
+    611,
+};
+static const short asc_6b[] = {
+    612, 613, 614,
+};
+static const short asc_6c[] = {
+    615,
+};
+static const short asc_6d[] = {
+    616,
+};
+static const short asc_6e[] = {
+    617,
+};
+static const short asc_6f[] = {
+    618, 619, 620, 621, 622, 623, 624, 625,
+};
+static const short asc_70[] = {
+    -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+    -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+    -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+    -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+    -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+    -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+    -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+    -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+    -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+    -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+    -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+    -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+    -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+    -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+    -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+    -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+    -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+    -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+    -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+    -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+    -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6, -6,
+    -6, -6, -6, -6,
+};
+static const short asc_71[] = {
+    626,
+};
+static const short asc_72[] = {
+    627, 628, 629, 630, 631, 632, 633, 634,
+};
+static const short asc_73[] = {
+    635, 636, 637, 638, 639, 640, 641, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 642, 643, 0, 0, 0, 0, 0, 644,
+};
+static const short asc_74[] = {
+    645, 646, 647, 648, 649, 650, 651, 652, 653, 654, 655, 656,
+    657, 658, 0, 0, 659, 660, 661, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 662, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    663, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 664, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 665, 666, 667, 668, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 669, 670, 0, 671, 0, 0, 0, 0, 0, 0,
+    0, 672,
+};
+
+const struct sg_lib_asc_idx_t sg_lib_asc_idx[256] = {
+    {asc_00, 33},
+    {asc_01, 1},
+    {asc_02, 1},
+    {asc_03, 3},
+    {asc_04, 29},
+    {asc_05, 1},
+    {asc_06, 1},
+    {asc_07, 1},
+    {asc_08, 5},
+    {asc_09, 5},
+    {asc_0a, 1},
+    {asc_0b, 10},
+    {asc_0c, 16},
+    {asc_0d, 6},
+    {asc_0e, 4},
+    {NULL, 0},
+    {asc_10, 6},
+    {asc_11, 21},
+    {asc_12, 1},
+    {asc_13, 1},
+    {asc_14, 8},
+    {asc_15, 3},
+    {asc_16, 5},
+    {asc_17, 10},
+    {asc_18, 9},
+    {asc_19, 4},
+    {asc_1a, 1},
+    {asc_1b, 1},
+    {asc_1c, 3},
+    {asc_1d, 2},
+    {asc_1e, 1},
+    {asc_1f, 1},
+    {asc_20, 13},
+    {asc_21, 4},
+    {asc_22, 1},
+    {asc_23, 11},
+    {asc_24, 9},
+    {asc_25, 1},
+    {asc_26, 19},
+    {asc_27, 8},
+    {asc_28, 4},
+    {asc_29, 8},
+    {asc_2a, 22},
+    {asc_2b, 1},
+    {asc_2c, 13},
+    {asc_2d, 1},
+    {asc_2e, 1},
+    {asc_2f, 4},
+    {asc_30, 20},
+    {asc_31, 4},
+    {asc_32, 2},
+    {asc_33, 1},
+    {asc_34, 1},
+    {asc_35, 6},
+    {asc_36, 1},
+    {asc_37, 1},
+    {asc_38, 8},
+    {asc_39, 1},
+    {asc_3a, 5},
+    {asc_3b, 29},
+    {NULL, 0},
+    {asc_3d, 1},
+    {asc_3e, 5},
+    {asc_3f, 21},
+    {asc_40, 256},
+    {asc_41, 256},
+    {asc_42, 256},
+    {asc_43, 1},
+    {asc_44, 114},
+    {asc_45, 1},
+    {asc_46, 1},
+    {asc_47, 128},
+    {asc_48, 1},
+    {asc_49, 1},
+    {asc_4a, 1},
+    {asc_4b, 14},
+    {asc_4c, 1},
+    {asc_4d, 256},
+    {asc_4e, 1},
+    {NULL, 0},
+    {asc_50, 3},
+    {asc_51, 2},
+    {asc_52, 1},
+    {asc_53, 9},
+    {asc_54, 1},
+    {asc_55, 14},
+    {NULL, 0},
+    {asc_57, 1},
+    {asc_58, 1},
+    {asc_59, 1},
+    {asc_5a, 4},
+    {asc_5b, 4},
+    {asc_5c, 3},
+    {asc_5d, 256},
+    {asc_5e, 72},
+    {NULL, 0},
+    {asc_60, 1},
+    {asc_61, 3},
+    {asc_62, 1},
+    {asc_63, 2},
+    {asc_64, 2},
+    {asc_65, 1},
+    {asc_66, 4},
+    {asc_67, 12},
+    {asc_68, 1},
+    {asc_69, 3},
+    {asc_6a, 1},
+    {asc_6b, 3},
+    {asc_6c, 1},
+    {asc_6d, 1},
+    {asc_6e, 1},
+    {asc_6f, 8},
+    {asc_70, 256},
+    {asc_71, 1},
+    {asc_72, 8},
+    {asc_73, 24},
+    {asc_74, 122},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+    {NULL, 0},
+};
+
+const short sg_lib_normal_opcodes_idx[256] = {
+    1, 2, 0, 4, 5, 8, 0, 9, 11, 0, 13, 16,
+    0, 0, 0, 19, 20, 22, 23, 24, 25, 26, 27, 29,
+    31, 32, 33, 34, 38, 39, 40, 0, 0, 0, 0, 41,
+    42, 43, 0, 0, 45, 46, 47, 48, 51, 52, 53, 54,
+    55, 56, 57, 58, 59, 61, 62, 63, 65, 66, 67, 68,
+    69, 70, 71, 72, 73, 74, 75, 77, 78, 79, 80, 81,
+    82, 0, 83, 84, 85, 86, 87, 0, 88, 89, 91, 93,
+    94, 95, 96, 98, 100, 0, 101, 102, 103, 104, 105, 106,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 107, 0, 108, 110, 112, 113,
+    114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125,
+    126, 127, 129, 131, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 133, 134, 135, 136, 137, 139, 140, 142, 144, 146, 148,
+    150, 151, 152, 153, 154, 156, 157, 158, 159, 160, 162, 163,
+    164, 165, 167, 169, 170, 171, 172, 174, 176, 177, 179, 181,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0,
+};
@@ -0,0 +1,94 @@
+/*
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the BSD_LICENSE file.
+ */
+
+/*
+ * Build time generator of the lookup indexes over the tables in
+ * sg_lib_data.c . It is compiled and linked with sg_lib_data.c (with the
+ * same defines as the library) and writes sg_lib_data_idx.c to stdout:
+ *   - per ASC, a sub-table indexed by ASCQ giving the matching entry of
+ *     sg_lib_asc_ascq[] or sg_lib_asc_ascq_range[]
+ *   - per opcode, the first entry of sg_lib_normal_opcodes[]
+ * so that sg_get_asc_ascq_str() and sg_get_opcode_name() need no scan.
+ * The choice of entry mirrors the previous linear scans: a range entry
+ * is preferred over a single entry and of equal entries the last wins.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sg_lib.h"
+#include "sg_lib_data.h"
+
+
+int
+main(int argc, char * argv[])
+{
+    short map[256][256];
+    int num[256];
+    int asc, ascq, k, n;
+    struct sg_lib_asc_ascq_t * eip;
+    struct sg_lib_asc_ascq_range_t * ei2p;
+    struct sg_lib_value_name_t * vp;
+
+    for (asc = 0; asc < 256; ++asc) {
+        num[asc] = 0;
+        for (ascq = 0; ascq < 256; ++ascq)
+            map[asc][ascq] = 0;
+    }
+    for (k = 0; sg_lib_asc_ascq[k].text; ++k) {
+        eip = &sg_lib_asc_ascq[k];
+        map[eip->asc][eip->ascq] = k + 1;
+    }
+    for (k = 0; sg_lib_asc_ascq_range[k].text; ++k) {
+        ei2p = &sg_lib_asc_ascq_range[k];
+        for (ascq = ei2p->ascq_min; ascq <= ei2p->ascq_max; ++ascq)
+            map[ei2p->asc][ascq] = -(k + 1);
+    }
+    for (asc = 0; asc < 256; ++asc) {
+        for (ascq = 255; ascq >= 0; --ascq) {
+            if (map[asc][ascq]) {
+                num[asc] = ascq + 1;
+                break;
+            }
+        }
+    }
+
+    printf("/*\n * Generated by sg_lib_idx_gen from sg_lib_data.c, "
+           "do not edit.\n */\n\n");
+    printf("#include <stdlib.h>\n\n#include \"sg_lib.h\"\n"
+           "#include \"sg_lib_data.h\"\n\n");
+
+    for (asc = 0; asc < 256; ++asc) {
+        if (0 == num[asc])
+            continue;
+        printf("static const short asc_%02x[] = {", asc);
+        for (ascq = 0; ascq < num[asc]; ++ascq)
+            printf("%s%d,", (ascq % 12) ? " " : "\n    ", map[asc][ascq]);
+        printf("\n};\n");
+    }
+
+    printf("\nconst struct sg_lib_asc_idx_t sg_lib_asc_idx[256] = {\n");
+    for (asc = 0; asc < 256; ++asc) {
+        if (num[asc])
+            printf("    {asc_%02x, %d},\n", asc, num[asc]);
+        else
+            printf("    {NULL, 0},\n");
+    }
+    printf("};\n\n");
+
+    printf("const short sg_lib_normal_opcodes_idx[256] = {");
+    for (k = 0; k < 256; ++k) {
+        n = 0;
+        for (vp = sg_lib_normal_opcodes; vp->name; ++vp) {
+            if (k == vp->value) {
+                n = (vp - sg_lib_normal_opcodes) + 1;
+                break;
+            }
+        }
+        printf("%s%d,", (k % 12) ? " " : "\n    ", n);
+    }
+    printf("\n};\n");
+    return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2013 HON HAI PRECISION IND.CO.,LTD. (FOXCONN)
+ *
+ * mbench.c - micro benchmark of the cpu side of diskio transfers
+ *
+ * Times the pattern fill of write_op() (random and user pattern) and
+ * the data compare of the wr mode in isolation, in ns/op and GB/s.
+ * diskio.c is included so that its static helpers are timed in place.
+ *
+ * usage: mbench [transfer size], e.g. mbench 64k
+ */
+
+#define main diskio_main
+#include "diskio.c"
+#undef main
+
+#define MB_SIZE         (64 * 1024)
+#define MB_MIN_NS       200000000ULL    /* run every item this long at least */
+
+static void *mb_buf;
+static void *mb_data;
+static int mb_len;
+static volatile int mb_sink;
+
+static unsigned long long mb_nsec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void mb_fill_random(void)
+{
+    use_random_pattern = 1;
+    fill_pattern(mb_buf, mb_len, mb_sink);
+}
+
+static void mb_fill_user(void)
+{
+    use_random_pattern = 0;
+    user_pattern = 0xaaaa5555;
+    fill_pattern(mb_buf, mb_len, 0);
+}
+
+/* a passing compare walks the whole transfer */
+static void mb_compare_prep(void)
+{
+    memcpy(mb_data, mb_buf, mb_len);
+}
+
+static void mb_compare(void)
+{
+    mb_sink += memcmp(mb_buf, mb_data, mb_len);
+}
+
+struct mb_item {
+    const char *name;
+    void (*func)(void);
+    void (*prep)(void);
+};
+
+static void mb_run(struct mb_item *it)
+{
+    unsigned long long n, i, t0, t;
+
+    if (it->prep)
+        it->prep();
+    /* double the ops until the run is long enough to trust */
+    for (n = 1; ; n *= 2) {
+        t0 = mb_nsec();
+        for (i = 0; i < n; i++)
+            it->func();
+        t = mb_nsec() - t0;
+        if (t >= MB_MIN_NS)
+            break;
+    }
+    printf("%-24s %8d %12.1f %10.2f\n", it->name, mb_len, (double)t / n,
+           (double)mb_len * n / t);
+}
+
+int main(int argc, char **argv)
+{
+    struct mb_item items[] = {
+        { "fill_pattern random", mb_fill_random, NULL },
+        { "fill_pattern user", mb_fill_user, NULL },
+        { "wr data compare", mb_compare, mb_compare_prep },
+        { NULL, NULL, NULL },
+    };
+    struct mb_item *it;
+
+    mb_len = (argc > 1) ? sg_get_num(argv[1]) : MB_SIZE;
+    if (mb_len <= 0 || mb_len % 4) {
+        fprintf(stderr, "usage: %s [transfer size, a multiple of 4]\n", argv[0]);
+        return 1;
+    }
+    if (posix_memalign(&mb_buf, 4096, mb_len) ||
+        posix_memalign(&mb_data, 4096, mb_len)) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    memset(mb_buf, 0x5a, mb_len);
+    memset(mb_data, 0x5a, mb_len);
+
+    printf("%-24s %8s %12s %10s\n", "item", "bytes", "ns/op", "GB/s");
+    for (it = items; it->name; it++)
+        mb_run(it);
+
+    free(mb_buf);
+    free(mb_data);
+    return mb_sink == 0x7fffffff;
+}
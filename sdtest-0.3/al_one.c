@@ -11,27 +11,38 @@
  * 2008-01-21 made initial version
  * 2008-02-22 accommodate the sd_err, with -1 as return value
  * 2008-03-05 added codes calculating 'diskstats'
+ * 2026-10-19 took the backup buffer from the buffer pool
+ *            'bseek' profiles the seeks by timed reads of one block at
+ *            track to track, 1/3 and full stroke and a distance curve
+ *            sequential transfers of a partial coverage are stratified
+ *            random transfers are whole ones within the test space, no
+ *            transfer past its end
+ *            'bseek' times the inward reads only, out of the read-ahead
+ *            a timed test ends the pass at its deadline
  *
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 #include <ctype.h>
 #include <sys/types.h>
 #include <sys/time.h>
+#include <time.h>
 
 #include "sdtest.h"
 #include "algos.h"
 #include "utils.h"
+#include "pool.h"
 #include "loads.h"
+#include "stats.h"
 
 typedef enum {
 	/* type0 */	
 	READ,
 	WRITE,
 	WRC,
-	SEEK,
 } one_ot;
 
 typedef enum {
@@ -47,10 +58,10 @@ static int al_one_rws(struct test_parm *p, void *d, one_ot type0, one_pt type1)
 	struct sd_load *load = NULL;
 	struct sd_device *dsk = d;
 	off_t offset = p->start, op = p->start;
-	off_t count = p->size / (p->block * p->blocks) * p->cover / 100;
-	off_t total = count + 1;
+	off_t total = p->size / (p->block * p->blocks) * p->cover / 100;
+	off_t count;
 	char *bak = NULL;
-	int i = 0, ret = 0, res = 0;
+	int ret = 0, res = 0;
 	int seed = 1;
 	
 	if (type1 == RANDOM)
@@ -61,7 +72,7 @@ static int al_one_rws(struct test_parm *p, void *d, one_ot type0, one_pt type1)
 
 	if (type0 == WRITE || type0 == WRC)
 		if (p->backup) {
-			bak = (char *)malloc(p->block * p->blocks);
+			bak = sd_poolget();
 			if (!bak) {
 				dsk->stat = SD_ERR_SYS;
 				return SD_ERR;
@@ -74,7 +85,24 @@ static int al_one_rws(struct test_parm *p, void *d, one_ot type0, one_pt type1)
 		return SD_ERR;
 	}
 
+	/* the transfers of the test space, at least one */
+	if (total < 1)
+		total = 1;
+	count = total - 1;
+
 	do {
+		/* a timed test ends the pass at the deadline, e.g. a slo probe */
+		if (count < total - 1 && sd_pastdue(p->deadline)) {
+			total -= count + 1;
+			break;
+		}
+
+		/* in order, or in chunks spread over the space by coverage */
+		if (type1 == SEQUENTIAL)
+			offset = p->start + sd_stratum(total - 1 - count, total,
+					p->size / (p->block * p->blocks))
+				* (p->block * p->blocks);
+
 		if (type1 == BUTTERFLY) {
 			if (op < 0)
 				offset = op * (-1);
@@ -82,8 +110,10 @@ static int al_one_rws(struct test_parm *p, void *d, one_ot type0, one_pt type1)
 				offset = op;
 		}
 
-		if (offset >= dsk->size)
-			offset = 0;
+		/* never outside the test space, e.g. a zone of the profile */
+		if (offset < p->start || offset + p->block * p->blocks
+				> p->start + p->size)
+			offset = p->start;
 		
 		if (type0 == WRITE || type0 == WRC)
 			if (p->backup) {
@@ -92,12 +122,7 @@ static int al_one_rws(struct test_parm *p, void *d, one_ot type0, one_pt type1)
 			}
 
 		if (type0 == WRC)
-			for (i = 0; i < p->block * p->blocks; i += 4) {
-				dsk->buf[i + 0] = (char)(p->pattern >> 24);
-				dsk->buf[i + 1] = (char)(p->pattern >> 16);
-				dsk->buf[i + 2] = (char)(p->pattern >> 8);
-				dsk->buf[i + 3] = (char)p->pattern;
-			}
+			sd_patfill(dsk->buf, p->block * p->blocks, p->pattern);
 
 		dsk->seek(dsk, offset);
 		if (type0 == READ)
@@ -128,21 +153,12 @@ static int al_one_rws(struct test_parm *p, void *d, one_ot type0, one_pt type1)
 				ret = SD_ERR;
 				break;
 			}
-			for (i = 0; i < p->block * p->blocks; i += 4) {
-				if (i + 4 > res)
-					break;
-				if ((dsk->buf[i] == (char)(p->pattern >> 24)) &&
-				(dsk->buf[i + 1] == (char)(p->pattern >> 16)) &&
-				(dsk->buf[i + 2] == (char)(p->pattern >> 8)) &&
-				(dsk->buf[i + 3] == (char)p->pattern))
-					continue;
+			if (sd_patcmp(dsk->buf, (res < p->block * p->blocks) ? res
+					: p->block * p->blocks, p->pattern) < 0) {
 				dsk->stat = SD_ERR_TEST;
 				ret = SD_ERR;
-				break;
 			}
-		} else if (type0 == SEEK)
-			;
-		else
+		} else
 			return SD_ERR_NO;
 		
 		if (type0 == WRITE || type0 == WRC)
@@ -163,9 +179,10 @@ static int al_one_rws(struct test_parm *p, void *d, one_ot type0, one_pt type1)
 		}
 		
 		if (type1 == SEQUENTIAL)
-			offset += p->block * p->blocks;
+			;	/* placed by its index above */
 		else if (type1 == RANDOM)
-			offset += sd_randget(p->size - p->start);
+			offset = p->start + sd_randxfer(p->size,
+					p->block * p->blocks);
 		else if (type1 == BUTTERFLY)
 			op = p->size - ((p->block * p->blocks) * (seed++)) - op;
 		else
@@ -209,7 +226,136 @@ static int al_one_rws(struct test_parm *p, void *d, one_ot type0, one_pt type1)
 
 	if (type0 == WRITE || type0 == WRC)
 		if (p->backup)
-			free(bak);
+			sd_poolput(bak);
+
+	return SD_ERR_NO;
+}
+
+#define SEEK_SAMPLES	64		/* timed seeks of every distance */
+#define SEEK_TRACK	(1024 * 1024)	/* about a track of a recent drive */
+#define SEEK_MIN	(64 * 1024)	/* shortest distance of the curve */
+
+/* one distance of the seek profile, the latency in a stats histogram */
+struct seek_dist {
+	const char *	name;	/* named stroke, NULL on the curve */
+	off_t		dist;	/* bytes between the two reads */
+	unsigned long long sum;	/* usec of all seeks */
+	struct sd_stat	st;
+};
+
+/* usec of a read of one block at 'to' after the heads read at 'from' */
+static long long al_seek_time(struct test_parm *p, struct sd_device *dsk,
+		off_t from, off_t to)
+{
+	struct timespec t0, t1;
+
+	dsk->seek(dsk, from);
+	if (dsk->read(dsk, dsk->buf, p->block) < 0)
+		return SD_ERR;
+	dsk->seek(dsk, to);
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	if (dsk->read(dsk, dsk->buf, p->block) < 0)
+		return SD_ERR;
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	return (t1.tv_sec - t0.tv_sec) * 1000000LL
+		+ (t1.tv_nsec - t0.tv_nsec) / 1000;
+}
+
+static void al_seek_report(struct seek_dist *sk, int n)
+{
+	char hist[512];
+	int b, len = 0;
+
+	/* the buckets hit, by their upper bound */
+	for (b = 0; b < LAT_BUCKETS && len < sizeof(hist) - 32; b++)
+		if (sk->st.lat[b])
+			len += snprintf(hist + len, sizeof(hist) - len, " %lluus:%llu",
+					1ULL << b, sk->st.lat[b]);
+	hist[len] = '\0';
+	tpterr("seek %s%s%lld bytes: avg %lluus p50 %lluus p99 %lluus,%s\n",
+			sk->name ? sk->name : "", sk->name ? " " : "",
+			(long long)sk->dist, sk->sum / n, sd_statlat(&sk->st, 50),
+			sd_statlat(&sk->st, 99), hist);
+}
+
+/*
+ * seek profile: every distance is timed as the read of one block that
+ * far before a read positioning the heads, from random places of the
+ * test space; the drive reads ahead of the positioning read, never
+ * behind it, so the timed block isn't in its cache and the time is the
+ * seek and the rotational latency, against the distance
+ */
+static int al_one_seek(struct test_parm *p, void *d)
+{
+	struct sd_time time;
+	struct sd_load *load = NULL;
+	struct sd_device *dsk = d;
+	struct seek_dist sk[64];
+	off_t stroke = p->size, full = stroke - stroke / 32, dist, from;
+	long long us;
+	int i, k, n = 0;
+
+	if (stroke < 4 * SEEK_MIN) {
+		tperr("bseek: test space under %d bytes\n", 4 * SEEK_MIN);
+		dsk->stat = SD_ERR_USR;
+		return SD_ERR;
+	}
+	if (sd_randinit()) {
+		dsk->stat = SD_ERR_SYS;
+		return SD_ERR;
+	}
+	load = sd_initload(dsk, &time);
+	if (!load) {
+		dsk->stat = SD_ERR_SYS;
+		return SD_ERR;
+	}
+
+	/* the strokes, then the curve doubling up to the full stroke */
+	memset(sk, 0, sizeof(sk));
+	if (SEEK_TRACK < stroke / 4) {
+		sk[n].name = "track";
+		sk[n++].dist = SEEK_TRACK;
+	}
+	sk[n].name = "third";
+	sk[n++].dist = stroke / 3;
+	sk[n].name = "full";
+	sk[n++].dist = full;
+	for (dist = SEEK_MIN; dist < full; dist *= 2)
+		sk[n++].dist = dist;
+
+	for (i = 0; i < n; i++) {
+		dist = sk[i].dist / p->block * p->block;
+		for (k = 0; k < SEEK_SAMPLES; k++) {
+			from = sd_randget(stroke - dist - p->block) / p->block
+				* p->block + p->start;
+			/* inward, an outward read may hit the read-ahead */
+			us = al_seek_time(p, dsk, from + dist, from);
+			if (us < 0) {
+				if (dsk->stat == SD_ERR_NO)
+					dsk->stat = SD_ERR_TEST;
+				sd_exitload(load);
+				return SD_ERR;
+			}
+			sk[i].sum += us;
+			sd_statadd(&sk[i].st, us);
+		}
+		if (!p->nopro)
+			tpout("%3d%%\b\b\b\b", (i + 1) * 100 / n);
+	}
+
+	for (i = 0; i < n; i++)
+		al_seek_report(&sk[i], SEEK_SAMPLES);
+
+	load->blk_total = (size_t)n * SEEK_SAMPLES * 2;
+	load->blk_read  = load->blk_total;
+	load->blk_wrtn  = 0;
+	load->tsf_read  = load->blk_total;
+	load->tsf_wrtn  = 0;
+	sd_caloads(load);
+	if (p->nopro < 2)
+		sd_prloads(load);
+	sd_exitload(load);
 
 	return SD_ERR_NO;
 }
@@ -261,7 +407,7 @@ static inline int al_butterfly_wrc(struct test_parm *p, void *d)
 
 static inline int al_butterfly_seek(struct test_parm *p, void *d)
 {
-	return al_one_rws(p, d, SEEK, BUTTERFLY);
+	return al_one_seek(p, d);
 }
 
 struct test_algo algo_one[] = {
@@ -11,6 +11,15 @@
  * 2008-01-24 made initial version
  * 2008-02-22 accommodate the sd_err, with -1 as return value
  * 2008-03-05 added codes calculating 'diskstats'
+ * 2026-10-19 kept offsets in the piece of the thread, 'p->start' is where
+ *            the piece begins
+ * 2026-10-19 took the backup buffer from the buffer pool
+ * 2026-10-19 sequential and random tests claim chunks of transfers from
+ *            the dispenser shared by threads when there is one
+ *            sequential transfers of a partial coverage are stratified
+ *            random transfers are whole ones within the piece, no
+ *            transfer past its end
+ *            a timed test ends the fixed piece of butterfly at its deadline
  *
  */
 
@@ -25,6 +34,7 @@
 #include "sdtest.h"
 #include "algos.h"
 #include "utils.h"
+#include "pool.h"
 #include "loads.h"
 
 typedef enum {
@@ -49,11 +59,25 @@ static int al_par_rws(struct test_parm *p, void *d, par_ot type0, par_pt type1)
 	struct sd_part *par = (struct sd_part *)d;
 	struct sd_device *dsk = NULL;
 	off_t offset = p->start, op = p->start;
-	off_t count = p->size / (p->block * p->blocks) * p->cover / 100;
-	off_t total = count + 1;
+	off_t total = p->size / (p->block * p->blocks) * p->cover / 100;
+	off_t count;
 	char *bak = NULL;
-	int i = 0, ret = 0, res = 0;
+	int ret = 0, res = 0;
 	int seed = 1;
+	/* butterfly keeps the fixed piece, its offsets depend on each other */
+	struct sd_disp *disp = (type1 != BUTTERFLY) ? par->disp : NULL;
+	off_t lo = p->start, span = p->size;
+	off_t k = 0, left = 0, done = 0, j = 0;
+
+	/* the transfers of the piece, at least one */
+	if (total < 1)
+		total = 1;
+	if (disp) {
+		lo = disp->start;
+		span = disp->size;
+		total = disp->total;
+	}
+	count = total - 1;
 	
 	/* map a private copy of sd_device per sd_part */
 	dsk = (struct sd_device *)malloc(sizeof(struct sd_device));
@@ -63,7 +87,7 @@ static int al_par_rws(struct test_parm *p, void *d, par_ot type0, par_pt type1)
 	}
 	memcpy(dsk, par->sd, sizeof(struct sd_device));
 	dsk->name = par->name;
-	dsk->size = par->size;
+	/* offsets are absolute, the io seek is bound by the device size */
 	dsk->pos  = par->pos;
 	dsk->buf  = par->buf;
 	dsk->parm = par->parm;
@@ -76,7 +100,7 @@ static int al_par_rws(struct test_parm *p, void *d, par_ot type0, par_pt type1)
 
 	if (type0 == WRITE || type0 == WRC)
 		if (p->backup) {
-			bak = (char *)malloc(p->block * p->blocks);
+			bak = sd_poolget();
 			if (!bak) {
 				dsk->stat = SD_ERR_SYS;
 				return SD_ERR;
@@ -90,6 +114,23 @@ static int al_par_rws(struct test_parm *p, void *d, par_ot type0, par_pt type1)
 	}
 
 	do {
+		/* claim the next chunk from the cursor of this pass */
+		if (disp && !left) {
+			k = sd_dispget(disp, par->pass, &left);
+			if (k < 0)
+				break;
+			j = k;
+		}
+		/* the dispenser stops claims at it, a fixed piece here */
+		if (!disp && done && sd_pastdue(p->deadline))
+			break;
+
+		/* in order, or in chunks spread over the space by coverage */
+		if (type1 == SEQUENTIAL)
+			offset = lo + sd_stratum(disp ? j : total - 1 - count, total,
+					span / (p->block * p->blocks))
+				* (p->block * p->blocks);
+
 		if (type1 == BUTTERFLY) {
 			if (op < 0)
 				offset = op * (-1);
@@ -97,8 +138,9 @@ static int al_par_rws(struct test_parm *p, void *d, par_ot type0, par_pt type1)
 				offset = op;
 		}
 
-		if (offset >= par->size)
-			offset = 0;
+		/* stay in the piece of this thread */
+		if (offset < lo || offset + p->block * p->blocks > lo + span)
+			offset = lo;
 		
 		if (type0 == WRITE || type0 == WRC)
 			if (p->backup) {
@@ -107,12 +149,7 @@ static int al_par_rws(struct test_parm *p, void *d, par_ot type0, par_pt type1)
 			}
 
 		if (type0 == WRC)
-			for (i = 0; i < p->block * p->blocks; i += 4) {
-				par->buf[i + 0] = (char)(p->pattern >> 24);
-				par->buf[i + 1] = (char)(p->pattern >> 16);
-				par->buf[i + 2] = (char)(p->pattern >> 8);
-				par->buf[i + 3] = (char)p->pattern;
-			}
+			sd_patfill(par->buf, p->block * p->blocks, p->pattern);
 
 		dsk->seek(dsk, offset);
 		if (type0 == READ)
@@ -145,17 +182,10 @@ static int al_par_rws(struct test_parm *p, void *d, par_ot type0, par_pt type1)
 				ret = SD_ERR;
 				break;
 			}
-			for (i = 0; i < p->block * p->blocks; i += 4) {
-				if (i + 4 > res)
-					break;
-				if ((dsk->buf[i] == (char)(p->pattern >> 24)) &&
-				(dsk->buf[i + 1] == (char)(p->pattern >> 16)) &&
-				(dsk->buf[i + 2] == (char)(p->pattern >> 8)) &&
-				(dsk->buf[i + 3] == (char)p->pattern))
-					continue;
+			if (sd_patcmp(dsk->buf, (res < p->block * p->blocks) ? res
+					: p->block * p->blocks, p->pattern) < 0) {
 				dsk->stat = SD_ERR_TEST;
 				ret = SD_ERR;
-				break;
 			}
 		} else if (type0 == SEEK)
 			;
@@ -180,17 +210,28 @@ static int al_par_rws(struct test_parm *p, void *d, par_ot type0, par_pt type1)
 		}
 		
 		if (type1 == SEQUENTIAL)
-			offset += p->block * p->blocks;
+			;	/* placed by its index above */
 		else if (type1 == RANDOM)
-			offset += sd_randget(p->size - p->start);
+			offset = lo + sd_randxfer(span, p->block * p->blocks);
 		else if (type1 == BUTTERFLY)
 			op = p->size - ((p->block * p->blocks) * (seed++)) - op;
 		else
 			return SD_ERR_NO;
 
+		done++;
+		if (disp) {
+			left--;
+			j++;
+		}
+
 		if (!p->nopro)
-			tpout("%3ld%%\b\b\b\b", (total - count) * 100 / total);
-	} while (count--);
+			tpout("%3ld%%\b\b\b\b", disp ? (k + 1) * 100 / total
+					: (total - count) * 100 / total);
+	} while (disp || count--);
+
+	/* only the transfers this thread claimed, or did before the deadline */
+	if (disp || done < total)
+		total = done;
 
 	if (type0 == READ) {
 		load->blk_total = p->blocks * total;
@@ -226,7 +267,7 @@ static int al_par_rws(struct test_parm *p, void *d, par_ot type0, par_pt type1)
 
 	if (type0 == WRITE || type0 == WRC)
 		if (p->backup)
-			free(bak);
+			sd_poolput(bak);
 
 	/* ensure one device status */
 	par->sd->stat = dsk->stat;
@@ -11,6 +11,7 @@
  * 2008-01-18 made initial version
  * 2008-02-22 accommodate the sd_err, with -1 as return value
  * 2008-03-05 added codes calculating 'diskstats'
+ * 2026-10-19 took the backup buffer from the buffer pool
  *
  */
 
@@ -24,6 +25,7 @@
 #include "sdtest.h"
 #include "algos.h"
 #include "utils.h"
+#include "pool.h"
 
 enum rws_type {
 	SEQUENTIAL,
@@ -134,7 +136,7 @@ static int al_rws_write(struct test_parm *p, void *d, enum rws_type type)
 		}
 
 	if (p->backup) {
-		bak = (char *)malloc(p->block * p->blocks);
+		bak = sd_poolget();
 		if (!bak) {
 			dsk->stat = SD_ERR_SYS;
 			return SD_ERR;
@@ -219,7 +221,7 @@ static int al_rws_write(struct test_parm *p, void *d, enum rws_type type)
 	}
 
 	if (p->backup)
-		free(bak);
+		sd_poolput(bak);
 
 	return SD_ERR_NO;
 }
@@ -232,7 +234,7 @@ static int al_rws_wrc(struct test_parm *p, void *d, enum rws_type type)
 	off_t count = p->size / (p->block * p->blocks) * p->cover / 100;
 	off_t total = count + 1;
 	char *bak = NULL;
-	int i = 0, ret = 0, res = 0;
+	int ret = 0, res = 0;
 	int seed = 1;
 	
 	if (type == RANDOM)
@@ -242,7 +244,7 @@ static int al_rws_wrc(struct test_parm *p, void *d, enum rws_type type)
 		}
 
 	if (p->backup) {
-		bak = (char *)malloc(p->block * p->blocks);
+		bak = sd_poolget();
 		if (!bak) {
 			dsk->stat = SD_ERR_SYS;
 			return SD_ERR;
@@ -270,12 +272,7 @@ static int al_rws_wrc(struct test_parm *p, void *d, enum rws_type type)
 			dsk->read(dsk, bak, p->block * p->blocks);
 		}
 
-		for (i = 0; i < p->block * p->blocks; i += 4) {
-			dsk->buf[i + 0] = (char)(p->pattern >> 24);
-			dsk->buf[i + 1] = (char)(p->pattern >> 16);
-			dsk->buf[i + 2] = (char)(p->pattern >> 8);
-			dsk->buf[i + 3] = (char)p->pattern;
-		}
+		sd_patfill(dsk->buf, p->block * p->blocks, p->pattern);
 		dsk->seek(dsk, offset);
 		res = dsk->write(dsk, dsk->buf, p->block * p->blocks);
 		if (res < 0) {
@@ -300,17 +297,10 @@ static int al_rws_wrc(struct test_parm *p, void *d, enum rws_type type)
 			ret = SD_ERR;
 			break;
 		}
-		for (i = 0; i < p->block * p->blocks; i += 4) {
-			if (i + 4 > res)
-				break;
-			if ((dsk->buf[i] == (char)(p->pattern >> 24)) && 
-				(dsk->buf[i + 1] == (char)(p->pattern >> 16)) &&
-				(dsk->buf[i + 2] == (char)(p->pattern >> 8)) &&
-				(dsk->buf[i + 3] == (char)p->pattern))
-				continue;
+		if (sd_patcmp(dsk->buf, (res < p->block * p->blocks) ? res
+				: p->block * p->blocks, p->pattern) < 0) {
 			dsk->stat = SD_ERR_TEST;
 			ret = SD_ERR;
-			break;
 		}
 
 		if (p->backup) {
@@ -366,7 +356,7 @@ static int al_rws_wrc(struct test_parm *p, void *d, enum rws_type type)
 	}
 
 	if (p->backup)
-		free(bak);
+		sd_poolput(bak);
 
 	return ret;
 }
@@ -0,0 +1,235 @@
+#!/bin/sh
+#
+# bench.sh - benchmark suite of sdtest and diskio
+#
+# Copyright (c) 2008 Jabil, Inc.
+#
+# This code is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 as
+# published by the Free Software Foundation.
+#
+# 2026-10-19 made initial version, a fixed matrix of tests, backends,
+#            transfer sizes and depths run a number of times on a loop
+#            device over a sparse file (or a given device), the median
+#            and spread of every point are written as one json baseline
+#            the caching mode page of the device goes with the baseline
+#            sdtest points are timed runs, their throughput is the one
+#            sdtest measures, see total.sh
+#            'bseek' goes in once per backend, unthreaded at depth 1, its
+#            reads are of one block so there is no size to sweep
+#
+# usage: bench.sh [-d device] [-t sdtest|diskio|all] [-n runs] [-s MiB]
+#                 [-T seconds] [-o baseline.json]
+#
+# every result is one line of the "results" array, so that benchcmp.sh
+# can compare two baselines with awk alone.
+#
+
+SDTEST=${SDTEST:-./sdtest}
+. "$(dirname "$0")/total.sh"
+DISKIO=${DISKIO:-../diskio/diskio}
+
+DEVICE=
+TOOLS=all
+RUNS=3
+SIZE=64		# MiB, a multiple of every transfer size
+TIME=1		# seconds of every sdtest run, passes repeat till the time is up
+OUT=
+
+# the matrix
+TESTS_ONE="sread rread bread swrite rwrite bwrite swrc rwrc bwrc"
+TESTS_SEEK="bseek"
+THREADS="0 4"
+BLOCKS="16 128 1024"
+DEPTHS="1 8"
+DISKIO_MODES="r w wr"
+
+usage()
+{
+	echo "usage: $0 [-d device] [-t sdtest|diskio|all] [-n runs] [-s MiB] [-T seconds] [-o baseline.json]"
+	exit 255
+}
+
+while getopts "d:t:n:s:T:o:h" opt; do
+	case $opt in
+	d) DEVICE=$OPTARG ;;
+	t) TOOLS=$OPTARG ;;
+	n) RUNS=$OPTARG ;;
+	s) SIZE=$OPTARG ;;
+	T) TIME=$OPTARG ;;
+	o) OUT=$OPTARG ;;
+	*) usage ;;
+	esac
+done
+
+if [ "$(id -u)" != 0 ]; then
+	echo "$0: must be run as root" >&2
+	exit 255
+fi
+
+# a sparse file on a loop device when no device is given
+IMG=
+LOOP=
+cleanup()
+{
+	[ -n "$LOOP" ] && losetup -d "$LOOP"
+	[ -n "$IMG" ] && rm -f "$IMG"
+	rm -f "$TMP"
+}
+trap cleanup EXIT
+trap 'exit 255' INT TERM
+
+TMP=$(mktemp /tmp/bench.XXXXXX) || exit 254
+if [ -z "$DEVICE" ]; then
+	IMG=$(mktemp /tmp/bench-img.XXXXXX) || exit 254
+	truncate -s "${SIZE}M" "$IMG" || exit 254
+	LOOP=$(losetup -f --show "$IMG") || exit 254
+	DEVICE=$LOOP
+fi
+
+VERSION=$($SDTEST -v 2>/dev/null)
+[ -z "$VERSION" ] && VERSION=unknown
+[ -z "$OUT" ] && OUT=bench-$(echo "$VERSION" | sed -n 's/.*Version \([^ ]*\).*/\1/p').json
+
+# median, min and max of the numbers on stdin, "null" if none
+stat3()
+{
+	sort -g | awk '{ v[NR] = $1 }
+	END {
+		if (!NR) { print "null null null"; exit }
+		if (NR % 2) m = v[(NR + 1) / 2]
+		else m = (v[NR / 2] + v[NR / 2 + 1]) / 2
+		printf "%.2f %.2f %.2f\n", m, v[1], v[NR]
+	}'
+}
+
+FIRST=1
+# record tool backend test threads blocks depth, samples in $TMP as
+# "mbps p50 p99" lines
+record()
+{
+	set -- "$@" $(cut -d' ' -f1 "$TMP" | stat3) \
+		$(cut -d' ' -f2 "$TMP" | grep -v null | stat3 | cut -d' ' -f1) \
+		$(cut -d' ' -f3 "$TMP" | grep -v null | stat3 | cut -d' ' -f1)
+	[ $FIRST = 1 ] || printf ",\n" >> "$OUT"
+	FIRST=0
+	printf '  {"tool": "%s", "backend": "%s", "test": "%s", "threads": %s, "blocks": %s, "depth": %s, "mbps": %s, "mbps_min": %s, "mbps_max": %s, "p50_us": %s, "p99_us": %s, "runs": %s}' \
+		"$1" "$2" "$3" "$4" "$5" "$6" "$7" "$8" "$9" "${10}" "${11}" \
+		$(wc -l < "$TMP") >> "$OUT"
+	echo "$1 $2 $3 t$4 g$5 q$6: $7 MB/s (${8}-${9}) p50 ${10}us p99 ${11}us"
+}
+
+# one sdtest run, appends "mbps p50 p99" to $TMP
+run_sdtest()
+{
+	res=$(run_total "$DEVICE" -s "${SIZE}m" -T "$TIME" "$@") || return 1
+	set -- $res
+	echo "$1 $3 $4" >> "$TMP"
+}
+
+# one diskio run, appends "mbps null null" to $TMP
+run_diskio()
+{
+	mbps=$($DISKIO "$DEVICE" "$@" -t 2>&1) || return 1
+	mbps=$(echo "$mbps" | sed -n 's/.* at \([0-9.]*\) MB\/sec.*/\1/p' | tail -1)
+	[ -z "$mbps" ] && return 1
+	echo "$mbps null null" >> "$TMP"
+}
+
+bench_sdtest()
+{
+	# backends: block device, direct io, sgio, bsg with depths
+	backends="sd direct"
+	$SDTEST -d "$DEVICE" -u -i >/dev/null 2>&1 && backends="$backends sg"
+	case "$DEVICE" in
+	/dev/bsg/*) backends="bsg" ;;
+	esac
+
+	for b in $backends; do
+		case $b in
+		sd)	opt= ;;
+		direct)	opt=-n ;;
+		sg)	opt=-u ;;
+		bsg)	opt= ;;
+		esac
+		for t in $TESTS_SEEK; do
+			: > "$TMP"
+			i=0
+			while [ $i -lt "$RUNS" ]; do
+				run_sdtest $opt -t $t -r 0 || break
+				i=$((i + 1))
+			done
+			if [ $i -lt "$RUNS" ]; then
+				echo "sdtest $b $t t0 g1 q1: failed, skipped" >&2
+				continue
+			fi
+			record sdtest $b $t 0 1 1
+		done
+		depths=1
+		[ $b = bsg ] && depths=$DEPTHS
+		for q in $depths; do
+		for t in $TESTS_ONE; do
+		for r in $THREADS; do
+		for g in $BLOCKS; do
+			: > "$TMP"
+			i=0
+			while [ $i -lt "$RUNS" ]; do
+				run_sdtest $opt -t $t -r $r -g $g -e $q || break
+				i=$((i + 1))
+			done
+			if [ $i -lt "$RUNS" ]; then
+				echo "sdtest $b $t t$r g$g q$q: failed, skipped" >&2
+				continue
+			fi
+			record sdtest $b $t $r $g $q
+		done
+		done
+		done
+		done
+	done
+}
+
+bench_diskio()
+{
+	if [ ! -x "$DISKIO" ]; then
+		echo "$DISKIO: not found, skipped" >&2
+		return
+	fi
+	for m in $DISKIO_MODES; do
+	for r in 1 4; do
+	for g in $BLOCKS; do
+	for q in $DEPTHS; do
+		: > "$TMP"
+		i=0
+		while [ $i -lt "$RUNS" ]; do
+			run_diskio $m -b=$((g * 512)) -m=${SIZE}m -j=$r -q=$q || break
+			i=$((i + 1))
+		done
+		if [ $i -lt "$RUNS" ]; then
+			echo "diskio sg $m t$r g$g q$q: failed, skipped" >&2
+			continue
+		fi
+		record diskio sg $m $r $g $q
+	done
+	done
+	done
+	done
+}
+
+# e.g. "wce 1 rcd 0 dra 0 prefetch 0-65535 segments 16", none if not scsi
+CACHE=$($SDTEST -d "$DEVICE" -i 2>/dev/null | sed -n 's/^Cache: //p')
+[ -z "$CACHE" ] && CACHE=none
+
+printf '{\n "version": "%s",\n "date": "%s",\n "host": "%s",\n "kernel": "%s",\n "device": "%s",\n "cache": "%s",\n "size": "%s",\n "time": %s,\n "runs": %s,\n "results": [\n' \
+	"$VERSION" "$(date +%Y-%m-%dT%H:%M:%S)" "$(uname -n)" "$(uname -r)" \
+	"$DEVICE" "$CACHE" "$SIZE" "$TIME" "$RUNS" > "$OUT"
+
+case $TOOLS in
+sdtest) bench_sdtest ;;
+diskio) bench_diskio ;;
+all)	bench_sdtest; bench_diskio ;;
+*)	usage ;;
+esac
+
+printf '\n ]\n}\n' >> "$OUT"
+echo "baseline written to $OUT"
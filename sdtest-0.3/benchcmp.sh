@@ -0,0 +1,87 @@
+#!/bin/sh
+#
+# benchcmp.sh - compare two baselines of bench.sh
+#
+# Copyright (c) 2008 Jabil, Inc.
+#
+# This code is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 as
+# published by the Free Software Foundation.
+#
+# 2026-10-19 made initial version
+#
+# usage: benchcmp.sh [-t threshold] base.json new.json
+#
+# a point regresses when its median throughput drops by more than the
+# threshold (percent, default 5) or by more than the spread of the runs
+# of the base, whichever is larger, or when its median p50/p99 latency
+# is more than twice the base.
+# exits 1 if any point regressed.
+#
+
+THRESHOLD=5
+
+while getopts "t:h" opt; do
+	case $opt in
+	t) THRESHOLD=$OPTARG ;;
+	*) echo "usage: $0 [-t threshold] base.json new.json"; exit 255 ;;
+	esac
+done
+shift $((OPTIND - 1))
+
+if [ $# -ne 2 ] || [ ! -r "$1" ] || [ ! -r "$2" ]; then
+	echo "usage: $0 [-t threshold] base.json new.json"
+	exit 255
+fi
+
+awk -v thr="$THRESHOLD" '
+function val(line, key,    s) {
+	if (!match(line, "\"" key "\": (\"[^\"]*\"|[^,}]*)"))
+		return ""
+	s = substr(line, RSTART + length(key) + 4, RLENGTH - length(key) - 4)
+	gsub("\"", "", s)
+	return s
+}
+/"tool":/ {
+	k = val($0, "tool") " " val($0, "backend") " " val($0, "test") \
+		" t" val($0, "threads") " g" val($0, "blocks") " q" val($0, "depth")
+	if (NR == FNR) {
+		keys[++n] = k
+		bm[k] = val($0, "mbps") + 0; blo[k] = val($0, "mbps_min") + 0
+		bhi[k] = val($0, "mbps_max") + 0
+		b50[k] = val($0, "p50_us"); b99[k] = val($0, "p99_us")
+	} else {
+		seen[k] = 1
+		nm[k] = val($0, "mbps") + 0
+		n50[k] = val($0, "p50_us"); n99[k] = val($0, "p99_us")
+	}
+}
+END {
+	bad = 0
+	for (i = 1; i <= n; i++) {
+		k = keys[i]
+		if (!(k in seen)) {
+			printf "%-36s missing\n", k
+			continue
+		}
+		tag = "ok"
+		# the noise band of the base runs
+		noise = thr
+		if (bm[k] > 0 && (bhi[k] - blo[k]) * 100 / bm[k] > noise)
+			noise = (bhi[k] - blo[k]) * 100 / bm[k]
+		d = bm[k] > 0 ? (nm[k] - bm[k]) * 100 / bm[k] : 0
+		if (d < -noise)
+			tag = "REGRESSED throughput"
+		if (b50[k] != "null" && n50[k] != "null" && n50[k] + 0 > 2 * b50[k])
+			tag = "REGRESSED p50"
+		if (b99[k] != "null" && n99[k] != "null" && n99[k] + 0 > 2 * b99[k])
+			tag = "REGRESSED p99"
+		if (tag != "ok")
+			bad++
+		printf "%-36s %9.2f -> %9.2f MB/s %+7.1f%% (noise %.1f%%) " \
+			"p99 %s -> %s us  %s\n", k, bm[k], nm[k], d, noise,
+			b99[k], n99[k], tag
+	}
+	printf "%d of %d points regressed\n", bad, n
+	exit bad ? 1 : 0
+}' "$1" "$2"
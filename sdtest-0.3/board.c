@@ -0,0 +1,131 @@
+/* board.c
+ *
+ * Author: Xiang-Yu Wang <rain_wang@jabil.com>
+ *
+ * Copyright (c) 2008 Jabil, Inc.
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * 2026-10-19 made initial version, a posix shared memory segment with
+ *            one status slot per sdtest child of process, written by
+ *            the stats collector of the child and read by process
+ *
+ */
+
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "sdtest.h"
+#include "utils.h"
+#include "board.h"
+
+struct sd_board *sd_boardinit(const char *name, int n)
+{
+	struct sd_board *bd;
+	int fd;
+
+	if (n < 1 || n > NUM_THREADS)
+		return NULL;
+
+	fd = shm_open(name, O_RDWR | O_CREAT | O_TRUNC, 0600);
+	if (fd < 0) {
+		tperr("board: %s: %s\n", name, strerror(errno));
+		return NULL;
+	}
+	if (ftruncate(fd, sizeof(*bd)) < 0) {
+		tperr("board: %s: %s\n", name, strerror(errno));
+		close(fd);
+		shm_unlink(name);
+		return NULL;
+	}
+	bd = mmap(NULL, sizeof(*bd), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (bd == MAP_FAILED) {
+		tperr("board: %s: %s\n", name, strerror(errno));
+		shm_unlink(name);
+		return NULL;
+	}
+
+	memset(bd, 0, sizeof(*bd));
+	bd->nslots = n;
+	__atomic_store_n(&bd->magic, BOARD_MAGIC, __ATOMIC_RELEASE);
+
+	return bd;
+}
+
+void sd_boardexit(struct sd_board *bd, const char *name)
+{
+	if (!bd)
+		return;
+	munmap(bd, sizeof(*bd));
+	shm_unlink(name);
+}
+
+struct sd_slot *sd_boardslot(const char *spec)
+{
+	struct sd_board *bd;
+	char name[NAME_MAX], *sep;
+	int fd, n;
+
+	sep = strrchr(spec, ':');
+	if (!sep || sep == spec || (sep - spec) >= sizeof(name))
+		return NULL;
+	memcpy(name, spec, sep - spec);
+	name[sep - spec] = '\0';
+	n = atoi(sep + 1);
+
+	fd = shm_open(name, O_RDWR, 0);
+	if (fd < 0) {
+		tperr("board: %s: %s\n", name, strerror(errno));
+		return NULL;
+	}
+	bd = mmap(NULL, sizeof(*bd), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (bd == MAP_FAILED) {
+		tperr("board: %s: %s\n", name, strerror(errno));
+		return NULL;
+	}
+
+	if (__atomic_load_n(&bd->magic, __ATOMIC_ACQUIRE) != BOARD_MAGIC
+			|| n < 0 || n >= bd->nslots) {
+		tperr("board: %s: no slot %d\n", name, n);
+		munmap(bd, sizeof(*bd));
+		return NULL;
+	}
+
+	/* the mapping lives as long as the child */
+	return &bd->slot[n];
+}
+
+void sd_boardget(struct sd_slot *slot, struct sd_slot *to)
+{
+	unsigned s0, s1;
+
+	do {
+		s0 = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+		memcpy(to, slot, sizeof(*to));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		s1 = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED);
+	} while ((s0 & 1) || s0 != s1);
+}
+
+void sd_boardput(struct sd_slot *slot, struct sd_slot *from)
+{
+	unsigned s = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED);
+
+	__atomic_store_n(&slot->seq, s + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	memcpy((char *)slot + sizeof(slot->seq), (char *)from + sizeof(from->seq),
+			sizeof(*slot) - sizeof(slot->seq));
+	__atomic_store_n(&slot->seq, s + 2, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,72 @@
+/* board.h
+ *
+ * Author: Xiang-Yu Wang <rain_wang@jabil.com>
+ *
+ * Copyright (c) 2008 Jabil, Inc.
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * 2026-10-19 made initial version
+ *
+ */
+
+#ifndef BOARD_H
+#define BOARD_H
+
+#include "sdtest.h"
+#include "stats.h"
+
+#define BOARD_MAGIC	0x73646264	/* "sdbd" */
+#define BOARD_SECS	1		/* default publish interval */
+
+/* slot states */
+enum {
+	BD_IDLE,
+	BD_RUN,
+	BD_PASS,
+	BD_FAIL,
+};
+
+/*
+ * status of one sdtest child; 'seq' is odd while the slot is being
+ * written, readers retry until they get an even and unchanged one
+ */
+struct sd_slot {
+	unsigned	seq;
+	int		pid;
+	int		state;
+	int		res;		/* exit value of last test */
+	char		device[32];
+	char		test[16];
+	unsigned long long start;	/* byte range of the child */
+	unsigned long long size;
+	unsigned long long bytes;	/* bytes transferred */
+	unsigned long long expect;	/* bytes expected in all passes */
+	unsigned long long lba;		/* current lba */
+	unsigned long long errs;	/* failed transfers */
+	unsigned	mbps;		/* MB/s of the last interval */
+	unsigned	secs;		/* seconds running */
+	unsigned	passed;		/* tests passed and failed */
+	unsigned	failed;
+} __attribute__((aligned(CACHE_LINE)));
+
+struct sd_board {
+	unsigned	magic;
+	int		nslots;
+	struct sd_slot	slot[NUM_THREADS];
+};
+
+/* create and remove a board in process */
+extern struct sd_board *sd_boardinit(const char *, int);
+extern void sd_boardexit(struct sd_board *, const char *);
+
+/* map slot of board "name:slot" in sdtest */
+extern struct sd_slot *sd_boardslot(const char *);
+
+/* copy a slot out of or into the board */
+extern void sd_boardget(struct sd_slot *, struct sd_slot *);
+extern void sd_boardput(struct sd_slot *, struct sd_slot *);
+
+#endif /* BOARD_H */
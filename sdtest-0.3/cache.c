@@ -0,0 +1,173 @@
+/* cache.c
+ *
+ * Author: Xiang-Yu Wang <rain_wang@jabil.com>
+ *
+ * Copyright (c) 2008 Jabil, Inc.
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * 2026-10-19 made initial version, the caching mode page is read by
+ *            mode sense(10) and changed by mode select(10) for a test,
+ *            the page found on the device is always put back at exit
+ *
+ */
+
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <scsi/sg_lib.h>
+#include <scsi/sg_cmds_basic.h>
+
+#include "sdtest.h"
+#include "utils.h"
+#include "cache.h"
+
+#define MODE_HDR_LEN	8	/* mode parameter header(10) */
+#define MODE_BUF_LEN	252
+
+/* the page found on the device, with the header for mode select */
+static unsigned char cache_orig[MODE_BUF_LEN];
+static int cache_len = 0;
+static int cache_fd = -1;
+
+/* 
+ * read the caching page without block descriptors into buf, return the
+ * offset of the page or -1
+ */
+static int sd_cachesense(int fd, unsigned char *buf)
+{
+	int off, res;
+
+	memset(buf, 0, MODE_BUF_LEN);
+	res = sg_ll_mode_sense10(fd, 0, 1, 0, CACHE_PAGE, 0, buf,
+			MODE_BUF_LEN, 0, 0);
+	if (res)
+		return SD_ERR;
+
+	off = MODE_HDR_LEN + ((buf[6] << 8) | buf[7]);
+	if (off + 16 > MODE_BUF_LEN || (buf[off] & 0x3f) != CACHE_PAGE
+			|| buf[off + 1] < 0x0a)
+		return SD_ERR;
+	return off;
+}
+
+/* the length of mode select data: header and page */
+static int sd_cachelen(unsigned char *buf, int off)
+{
+	int len = off + buf[off + 1] + 2;
+
+	return (len > MODE_BUF_LEN) ? MODE_BUF_LEN : len;
+}
+
+int sd_cacheparse(const char *spec, struct sd_cache *want, int *ab)
+{
+	char key[8];
+	int val, n;
+
+	memset(want, 0xff, sizeof(*want));
+	*ab = 0;
+	if (!strcmp(spec, "ab")) {
+		*ab = 1;
+		return SD_ERR_NO;
+	}
+
+	while (*spec) {
+		if (sscanf(spec, "%7[a-z]=%d%n", key, &val, &n) != 2
+				|| (val != 0 && val != 1))
+			return SD_ERR;
+		if (!strcmp(key, "wce"))
+			want->wce = val;
+		else if (!strcmp(key, "rcd"))
+			want->rcd = val;
+		else if (!strcmp(key, "dra"))
+			want->dra = val;
+		else
+			return SD_ERR;
+		spec += n;
+		if (*spec == ',')
+			spec++;
+		else if (*spec)
+			return SD_ERR;
+	}
+
+	return SD_ERR_NO;
+}
+
+int sd_cacheget(int fd, struct sd_cache *cache)
+{
+	unsigned char buf[MODE_BUF_LEN], *pg;
+	int off;
+
+	if ((off = sd_cachesense(fd, buf)) < 0)
+		return SD_ERR;
+	pg = buf + off;
+
+	cache->wce = !!(pg[2] & 0x04);
+	cache->rcd = !!(pg[2] & 0x01);
+	cache->minpf = (pg[6] << 8) | pg[7];
+	cache->maxpf = (pg[8] << 8) | pg[9];
+	/* the bytes after maximum prefetch ceiling came with SCSI-3 */
+	cache->dra = (pg[1] >= 0x12) ? !!(pg[12] & 0x20) : 0;
+	cache->segs = (pg[1] >= 0x12) ? pg[13] : 0;
+
+	return SD_ERR_NO;
+}
+
+static int sd_cacheselect(int fd, unsigned char *buf, int len)
+{
+	/* mode data length is reserved in mode select, ps bit too */
+	buf[0] = buf[1] = 0;
+	buf[3] = 0;
+	buf[MODE_HDR_LEN + ((buf[6] << 8) | buf[7])] &= 0x7f;
+
+	return sg_ll_mode_select10(fd, 1, 0, buf, len, 1, 0);
+}
+
+int sd_cacheset(int fd, const struct sd_cache *want)
+{
+	unsigned char buf[MODE_BUF_LEN], *pg;
+	int off;
+
+	if ((off = sd_cachesense(fd, buf)) < 0) {
+		tperr("cache: can't read the caching mode page\n");
+		return SD_ERR;
+	}
+	if (cache_fd < 0) {
+		memcpy(cache_orig, buf, sizeof(buf));
+		cache_len = sd_cachelen(buf, off);
+		cache_fd = fd;
+		atexit(sd_cacherestore);
+	}
+
+	pg = buf + off;
+	if (want->wce >= 0)
+		pg[2] = (pg[2] & ~0x04) | (want->wce ? 0x04 : 0);
+	if (want->rcd >= 0)
+		pg[2] = (pg[2] & ~0x01) | (want->rcd ? 0x01 : 0);
+	if (want->dra >= 0 && pg[1] >= 0x12)
+		pg[12] = (pg[12] & ~0x20) | (want->dra ? 0x20 : 0);
+
+	if (sd_cacheselect(fd, buf, sd_cachelen(buf, off))) {
+		tperr("cache: can't change the caching mode page\n");
+		return SD_ERR;
+	}
+
+	return SD_ERR_NO;
+}
+
+void sd_cacherestore(void)
+{
+	unsigned char buf[MODE_BUF_LEN];
+
+	if (cache_fd < 0)
+		return;
+	/* select clears fields of the buffer, keep the original */
+	memcpy(buf, cache_orig, sizeof(buf));
+	if (sd_cacheselect(cache_fd, buf, cache_len))
+		tperr("cache: can't restore the caching mode page\n");
+	cache_fd = -1;
+}
@@ -0,0 +1,49 @@
+/* cache.h
+ *
+ * Author: Xiang-Yu Wang <rain_wang@jabil.com>
+ *
+ * Copyright (c) 2008 Jabil, Inc.
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * 2026-10-19 made initial version
+ *
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+/* caching mode page */
+#define CACHE_PAGE	0x08
+
+/* 
+ * settings of the caching mode page, -1 in a wanted setting keeps
+ * what the device has
+ */
+struct sd_cache {
+	int		wce;	/* write cache enable */
+	int		rcd;	/* read cache disable */
+	int		dra;	/* disable read ahead */
+	int		minpf;	/* minimum prefetch, blocks */
+	int		maxpf;	/* maximum prefetch, blocks */
+	int		segs;	/* number of cache segments */
+};
+
+/* parse "wce=0,rcd=1,dra=0" into wanted settings, or "ab" for A/B */
+extern int sd_cacheparse(const char *, struct sd_cache *, int *);
+
+/* read the current settings of the device */
+extern int sd_cacheget(int, struct sd_cache *);
+
+/* 
+ * change the settings for the test, the first change keeps the page
+ * found on the device, which is put back at exit
+ */
+extern int sd_cacheset(int, const struct sd_cache *);
+
+/* put the original page back, also called at exit */
+extern void sd_cacherestore(void);
+
+#endif /* CACHE_H */
@@ -0,0 +1,321 @@
+/* cpus.c
+ *
+ * Author: Xiang-Yu Wang <rain_wang@jabil.com>
+ *
+ * Copyright (c) 2008 Jabil, Inc.
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * 2026-10-19 made initial version, cpu affinity of test threads and numa
+ *            node local buffers, the device's node is found in sysfs
+ *            'sd_queueattr' of the request queue limits in sysfs
+ *            'sd_serial' of the device serial number in sysfs, with the
+ *            start sector of a partition
+ *
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include "sdtest.h"
+#include "utils.h"
+#include "cpus.h"
+
+#ifndef MPOL_BIND
+#define MPOL_BIND	2
+#endif
+
+/* nodes in the mbind mask */
+#define MAX_NODES	1024
+
+int sd_cpuparse(const char *list, int *cpus, int max)
+{
+	const char *s = list;
+	char *end;
+	long a, b;
+	int n = 0;
+
+	while (*s) {
+		a = strtol(s, &end, 10);
+		if (end == s || a < 0)
+			return -1;
+		b = a;
+		if (*end == '-') {
+			s = end + 1;
+			b = strtol(s, &end, 10);
+			if (end == s || b < a)
+				return -1;
+		}
+		for (; a <= b; a++) {
+			if (n >= max || a >= CPU_SETSIZE)
+				return -1;
+			cpus[n++] = a;
+		}
+		if (*end == ',')
+			end++;
+		else if (*end)
+			return -1;
+		s = end;
+	}
+
+	return n ? n : -1;
+}
+
+int sd_cpubind(int cpu)
+{
+	cpu_set_t set;
+	int res;
+
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	res = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+	if (res) {
+		tperr("cpu %d: can't bind (%s)\n", cpu, strerror(res));
+		return SD_ERR;
+	}
+
+	return SD_ERR_NO;
+}
+
+/*
+ * the sysfs directory of the device node: block devices and partitions
+ * are in class 'block', sg and bsg nodes in their own classes
+ */
+static int sd_sysdir(const char *device, char *path, size_t len)
+{
+	const char *classes[] = { "block", "scsi_generic", "bsg", NULL };
+	const char *name;
+	struct stat st;
+	int i;
+
+	name = strrchr(device, '/');
+	name = name ? name + 1 : device;
+
+	for (i = 0; classes[i]; i++) {
+		snprintf(path, len, "/sys/class/%s/%s", classes[i], name);
+		if (stat(path, &st) == 0)
+			return SD_ERR_NO;
+	}
+
+	return SD_ERR;
+}
+
+int sd_numanode(const char *device)
+{
+	char path[PATH_MAX], real[PATH_MAX], file[PATH_MAX + 16];
+	char *slash;
+	FILE *fp;
+	int node = -1;
+
+	if (sd_sysdir(device, path, sizeof(path)) < 0)
+		return -1;
+	if (!realpath(path, real))
+		return -1;
+
+	/* the host adapter up the device path has the numa node */
+	while ((slash = strrchr(real, '/')) && slash != real) {
+		snprintf(file, sizeof(file), "%s/numa_node", real);
+		if ((fp = fopen(file, "r"))) {
+			if (fscanf(fp, "%d", &node) != 1)
+				node = -1;
+			fclose(fp);
+			break;
+		}
+		*slash = '\0';
+	}
+	sd_debug("%s: numa node %d\n", device, node);
+
+	return node;
+}
+
+int sd_nodebind(char *buf, size_t size, int node)
+{
+	unsigned long mask[MAX_NODES / (8 * sizeof(unsigned long))];
+
+	if (node < 0 || node >= MAX_NODES)
+		return SD_ERR;
+
+	memset(mask, 0, sizeof(mask));
+	mask[node / (8 * sizeof(unsigned long))] |=
+		1UL << (node % (8 * sizeof(unsigned long)));
+	if (syscall(SYS_mbind, buf, size, MPOL_BIND, mask, MAX_NODES, 0) < 0) {
+		tperr("numa: can't bind buffer to node %d (%s)\n",
+				node, strerror(errno));
+		return SD_ERR;
+	}
+
+	return SD_ERR_NO;
+}
+
+/*
+ * the directory 'sub' of the request queue side of the device: of the
+ * whole disk for a partition, of the block device of the same scsi
+ * device for sg and bsg nodes
+ */
+static int sd_sysqueue(const char *device, const char *sub, char *dir,
+		size_t len)
+{
+	char path[PATH_MAX], blk[PATH_MAX + 16], file[PATH_MAX + 16];
+	struct dirent *de;
+	struct stat st;
+	DIR *dp;
+
+	if (sd_sysdir(device, path, sizeof(path)) < 0)
+		return SD_ERR;
+
+	snprintf(file, sizeof(file), "%s/partition", path);
+	if (stat(file, &st) == 0)
+		snprintf(dir, len, "%s/../%s", path, sub);
+	else
+		snprintf(dir, len, "%s/%s", path, sub);
+
+	/* sg and bsg nodes, see the block device of the same scsi device */
+	if (stat(dir, &st) < 0) {
+		snprintf(blk, sizeof(blk), "%s/device/block", path);
+		if (!(dp = opendir(blk)))
+			return SD_ERR;
+		while ((de = readdir(dp)) && de->d_name[0] == '.')
+			;
+		if (de)
+			snprintf(dir, len, "%s/%s/%s", blk, de->d_name, sub);
+		closedir(dp);
+		if (!de)
+			return SD_ERR;
+	}
+
+	return SD_ERR_NO;
+}
+
+long sd_queueattr(const char *device, const char *attr)
+{
+	char dir[2 * PATH_MAX], file[3 * PATH_MAX];
+	long val = -1;
+	FILE *fp;
+
+	if (sd_sysqueue(device, "queue", dir, sizeof(dir)) < 0)
+		return -1;
+	snprintf(file, sizeof(file), "%s/%s", dir, attr);
+	if (!(fp = fopen(file, "r")))
+		return -1;
+	if (fscanf(fp, "%ld", &val) != 1)
+		val = -1;
+	fclose(fp);
+	sd_debug("%s: %s %ld\n", device, attr, val);
+
+	return val;
+}
+
+/* the partitions of a disk share its serial, their start tells them apart */
+static void sd_serialpart(const char *device, char *serial, size_t len)
+{
+	char path[PATH_MAX], file[PATH_MAX + 16];
+	long long start;
+	size_t n;
+	FILE *fp;
+
+	if (sd_sysdir(device, path, sizeof(path)) < 0)
+		return;
+	snprintf(file, sizeof(file), "%s/partition", path);
+	if (access(file, F_OK) < 0)
+		return;
+	snprintf(file, sizeof(file), "%s/start", path);
+	if (!(fp = fopen(file, "r")))
+		return;
+	if (fscanf(fp, "%lld", &start) == 1) {
+		n = strlen(serial);
+		snprintf(serial + n, len - n, "-start%lld", start);
+	}
+	fclose(fp);
+}
+
+int sd_serial(const char *device, char *serial, size_t len)
+{
+	const char *files[] = { "serial", "device/serial", "device/vpd_pg80",
+		"device/wwid", NULL };
+	char dir[2 * PATH_MAX], file[3 * PATH_MAX];
+	unsigned char buf[256];
+	size_t n, i, j;
+	int k, off;
+	FILE *fp;
+
+	if (sd_sysqueue(device, "", dir, sizeof(dir)) < 0)
+		return SD_ERR;
+
+	for (k = 0; files[k]; k++) {
+		snprintf(file, sizeof(file), "%s/%s", dir, files[k]);
+		if (!(fp = fopen(file, "r")))
+			continue;
+		n = fread(buf, 1, sizeof(buf) - 1, fp);
+		fclose(fp);
+
+		/* unit serial number page, 4 bytes of header */
+		off = strcmp(files[k], "device/vpd_pg80") ? 0 : 4;
+		if (off && (n < 4 || buf[3] + 4 < n))
+			n = n < 4 ? 0 : buf[3] + 4;
+
+		/* trimmed, anything but a file name character as '_' */
+		for (i = off; i < n && (buf[i] == ' ' || buf[i] == '\0'); i++)
+			;
+		while (n > i && (buf[n - 1] <= ' ' || buf[n - 1] > '~'))
+			n--;
+		for (j = 0; i < n && j < len - 1; i++, j++)
+			serial[j] = (isalnum(buf[i]) || buf[i] == '-' ||
+				buf[i] == '.') ? buf[i] : '_';
+		serial[j] = '\0';
+		if (j) {
+			sd_serialpart(device, serial, len);
+			sd_debug("%s: serial %s from %s\n", device, serial,
+				files[k]);
+			return SD_ERR_NO;
+		}
+	}
+
+	return SD_ERR;
+}
+
+void sd_prmqmap(const char *device)
+{
+	char dir[2 * PATH_MAX], file[3 * PATH_MAX];
+	char line[256];
+	struct dirent *de;
+	DIR *dp;
+	FILE *fp;
+
+	if (sd_sysqueue(device, "mq", dir, sizeof(dir)) < 0)
+		return;
+
+	if (!(dp = opendir(dir))) {
+		tpout("blk-mq: no hardware queues\n");
+		return;
+	}
+	while ((de = readdir(dp))) {
+		if (de->d_name[0] == '.')
+			continue;
+		snprintf(file, sizeof(file), "%s/%s/cpu_list", dir, de->d_name);
+		if (!(fp = fopen(file, "r")))
+			continue;
+		if (fgets(line, sizeof(line), fp)) {
+			line[strcspn(line, "\n")] = '\0';
+			tpout("blk-mq: hw queue %s: cpus %s\n", de->d_name, line);
+		}
+		fclose(fp);
+	}
+	closedir(dp);
+}
@@ -0,0 +1,44 @@
+/* cpus.h
+ *
+ * Author: Xiang-Yu Wang <rain_wang@jabil.com>
+ *
+ * Copyright (c) 2008 Jabil, Inc.
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * 2026-10-19 made initial version
+ *
+ */
+
+#ifndef CPUS_H
+#define CPUS_H
+
+#include <sys/types.h>
+
+/* cpus in a cpu list, e.g. 0-3,8 */
+#define MAX_CPUS	1024
+
+/* parse a cpu list into cpus, return the number of cpus or -1 */
+extern int sd_cpuparse(const char *, int *, int);
+
+/* bind the calling thread to a cpu */
+extern int sd_cpubind(int);
+
+/* numa node local to the device, -1 if unknown */
+extern int sd_numanode(const char *);
+
+/* bind memory not yet touched to a numa node */
+extern int sd_nodebind(char *, size_t, int);
+
+/* print the blk-mq hardware queue to cpu mapping of the device */
+extern void sd_prmqmap(const char *);
+
+/* a request queue attribute in sysfs, e.g. max_sectors_kb, or -1 */
+extern long sd_queueattr(const char *, const char *);
+
+/* serial of the device in sysfs as a file name, a partition's with its start */
+extern int sd_serial(const char *, char *, size_t);
+
+#endif /* CPUS_H */
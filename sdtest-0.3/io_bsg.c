@@ -0,0 +1,443 @@
+/* io_bsg.c
+ *
+ * Author: Xiang-Yu Wang <rain_wang@jabil.com>
+ *
+ * Copyright (c) 2008 Jabil, Inc.
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * 2026-10-19 derived from 'io_sg.c', made initial version. the bsg
+ *            device node is accessed with the sg v4 interface, up to
+ *            'depth' commands of a transfer are kept outstanding by
+ *            write()/read() on the node when the kernel allows
+ *            fua writes of sync modes, 'flush_bsg' in
+ *            'maxget_bsg' in, transfers are split into commands of 'cmdmax'
+ *            read capacity(16) first in 'blkget_bsg', physical block and
+ *            alignment from it
+ *            added 'bseek' to the tests
+ *            queued io only falls back to depth 1 on 'not supported'
+ *            errnos, a busy node is retried once one command is reaped,
+ *            'bsg_drain' in for the commands left by a reap error
+ *
+ */
+
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <linux/bsg.h>
+
+#include <scsi/sg_lib.h>
+#include <scsi/sg_io_linux.h>
+
+#include "sdtest.h"
+#include "utils.h"
+
+#define DEF_SCSI_CDBSZ 10
+#define MAX_SCSI_CDBSZ 16
+
+#define SENSE_BUFF_LEN 32       /* Arbitrary, could be larger */
+#define DEF_TIMEOUT 40000       /* 40,000 millisecs == 40 seconds */
+
+/*
+ * one outstanding command
+ */
+struct bsg_req {
+	struct sg_io_v4	hdr;
+	unsigned char	cdb[MAX_SCSI_CDBSZ];
+	unsigned char	sense[SENSE_BUFF_LEN];
+};
+
+static __thread struct bsg_req *reqs = NULL;	/* per thread command slots */
+static __thread int *slots = NULL;	/* stack of free slots */
+static __thread int nreqs = 0;
+
+/*
+ * queued io by write()/read() on bsg node has been dropped by newer
+ * kernels, fall back to SG_IO ioctl once it's refused.
+ */
+static int queued = 1;
+
+static int bsg_build_cdb(unsigned char *cdbp, int cdb_sz, unsigned int blocks,
+			 long long start_block, int write_true, int fua)
+{
+	int k, sz_ind = (cdb_sz == 16);
+	int rd_opcode[] = {0x28, 0x88};
+	int wr_opcode[] = {0x2a, 0x8a};
+
+	memset(cdbp, 0, cdb_sz);
+	cdbp[0] = (unsigned char)(write_true ? wr_opcode[sz_ind] :
+				  rd_opcode[sz_ind]);
+	if (fua)
+		cdbp[1] |= 0x8;
+	if (cdb_sz == 16) {
+		for (k = 0; k < 8; k++)
+			cdbp[2 + k] = (unsigned char)(start_block >> (56 - 8 * k));
+		for (k = 0; k < 4; k++)
+			cdbp[10 + k] = (unsigned char)(blocks >> (24 - 8 * k));
+	} else {
+		for (k = 0; k < 4; k++)
+			cdbp[2 + k] = (unsigned char)(start_block >> (24 - 8 * k));
+		cdbp[7] = (unsigned char)((blocks >> 8) & 0xff);
+		cdbp[8] = (unsigned char)(blocks & 0xff);
+	}
+	return 0;
+}
+
+static void bsg_prep(struct bsg_req *req, int cdbsz, int write_true,
+		     void *buf, int len)
+{
+	memset(&req->hdr, 0, sizeof(req->hdr));
+	req->hdr.guard = 'Q';
+	req->hdr.protocol = BSG_PROTOCOL_SCSI;
+	req->hdr.subprotocol = BSG_SUB_PROTOCOL_SCSI_CMD;
+	req->hdr.request_len = cdbsz;
+	req->hdr.request = (uintptr_t)req->cdb;
+	req->hdr.max_response_len = sizeof(req->sense);
+	req->hdr.response = (uintptr_t)req->sense;
+	if (write_true) {
+		req->hdr.dout_xfer_len = len;
+		req->hdr.dout_xferp = (uintptr_t)buf;
+	} else {
+		req->hdr.din_xfer_len = len;
+		req->hdr.din_xferp = (uintptr_t)buf;
+	}
+	req->hdr.timeout = DEF_TIMEOUT;
+	req->hdr.usr_ptr = (uintptr_t)req;
+}
+
+/* 0 -> successful, 2 -> try again (e.g. unit attention), -1 -> error */
+static int bsg_check(struct sd_device *sd, struct bsg_req *req, int write_true)
+{
+	const char *op = write_true ? "WRITE" : "READ";
+	int res;
+
+	res = sg_err_category_new(req->hdr.device_status,
+			req->hdr.transport_status, req->hdr.driver_status,
+			req->sense, req->hdr.response_len);
+	switch (res) {
+	case SG_LIB_CAT_RECOVERED:
+	case SG_LIB_CAT_CLEAN:
+		return 0;
+	case SG_LIB_CAT_UNIT_ATTENTION:
+		tperr("SCSI %s unit attention\n", op);
+		return 2;
+	case SG_LIB_CAT_ABORTED_COMMAND:
+		tperr("SCSI %s aborted command\n", op);
+		break;
+	case SG_LIB_CAT_NOT_READY:
+		tperr("device not ready\n");
+		break;
+	case SG_LIB_CAT_MEDIUM_HARD:
+		tperr("SCSI %s medium/hardware error\n", op);
+		break;
+	default:
+		tperr("SCSI %s failed\n", op);
+		break;
+	}
+	if (req->hdr.response_len)
+		sg_print_sense(op, req->sense, req->hdr.response_len, 0);
+	sd_debug("sd->pos %ld\n", sd->pos);
+	sd->stat = SD_ERR_SGIO;
+	return -1;
+}
+
+/* issue and wait, unit attention is tried once again */
+static int bsg_sync(struct sd_device *sd, struct bsg_req *req, int write_true)
+{
+	int res;
+
+	if (ioctl(sd->fd, SG_IO, &req->hdr) < 0) {
+		tperr("%s (SG_IO v4): %s\n", write_true ? "writing" : "reading",
+				strerror(errno));
+		sd->stat = SD_ERR_SGIO;
+		return -1;
+	}
+	res = bsg_check(sd, req, write_true);
+	if (res == 2) {
+		if (ioctl(sd->fd, SG_IO, &req->hdr) < 0) {
+			sd->stat = SD_ERR_SGIO;
+			return -1;
+		}
+		res = bsg_check(sd, req, write_true);
+	}
+	return res ? -1 : 0;
+}
+
+static int bsg_slots(int depth)
+{
+	int i;
+
+	if (depth <= nreqs)
+		return 0;
+
+	free(reqs);
+	free(slots);
+	reqs = calloc(depth, sizeof(*reqs));
+	slots = calloc(depth, sizeof(*slots));
+	if (!reqs || !slots) {
+		nreqs = 0;
+		return -1;
+	}
+	for (i = 0; i < depth; i++)
+		slots[i] = i;
+	nreqs = depth;
+	return 0;
+}
+
+/*
+ * a refused write() of a command, the kernel has no queued io on bsg
+ */
+static int bsg_unqueued(int err)
+{
+	return err == EINVAL || err == ENOSYS || err == EOPNOTSUPP;
+}
+
+/*
+ * reap the commands still outstanding on 'fd' after an error, or drop
+ * them by reopening the node over 'fd' so the next transfer won't reap
+ * them into reused slots
+ */
+static int bsg_drain(int fd, int inflight)
+{
+	struct sg_io_v4 done;
+	char path[64];
+	int n, nfd;
+
+	while (inflight) {
+		memset(&done, 0, sizeof(done));
+		done.guard = 'Q';
+		while ((n = read(fd, &done, sizeof(done))) < 0 && errno == EINTR)
+			;
+		if (n != sizeof(done))
+			break;
+		inflight--;
+	}
+	if (!inflight)
+		return 0;
+
+	snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+	nfd = open(path, fcntl(fd, F_GETFL) & (O_ACCMODE | O_NONBLOCK));
+	if (nfd < 0 || dup2(nfd, fd) < 0) {
+		tperr("bsg: dropping commands: %s\n", strerror(errno));
+		if (nfd >= 0)
+			close(nfd);
+		return -1;
+	}
+	close(nfd);
+	return 0;
+}
+
+static int bsg_xfer(struct sd_device *sd, unsigned char *buf, size_t size,
+		    int write_true)
+{
+	struct sg_io_v4 done;
+	struct bsg_req *req;
+	int n_blocks, blocks, blocks_per;
+	int depth = sd->parm->depth;
+	int fua = write_true && (sd->parm->sync == SD_SYNC_DSYNC
+			|| sd->parm->sync == SD_SYNC_FUA);
+	int nfree, inflight = 0, cdbsz, res;
+	int ret = SD_ERR_NO;
+
+	n_blocks = size / sd->bs + ((size % sd->bs) ? 1 : 0);
+	blocks_per = sd->parm->blocks;
+	if (sd->cmdmax && blocks_per * sd->bs > sd->cmdmax)
+		blocks_per = sd->cmdmax / sd->bs;
+	if (depth < 1 || !queued)
+		depth = 1;
+
+	if (bsg_slots(depth) < 0) {
+		sd->stat = SD_ERR_SYS;
+		return SD_ERR;
+	}
+	nfree = depth;
+
+	while (n_blocks > 0 || inflight) {
+		/* keep up to 'depth' commands outstanding */
+		while (n_blocks > 0 && nfree && ret == SD_ERR_NO) {
+			blocks = (n_blocks > blocks_per) ? blocks_per : n_blocks;
+			req = &reqs[slots[--nfree]];
+			cdbsz = DEF_SCSI_CDBSZ;
+			if ((sd->pos + blocks) > 0xffffffffLL || blocks > 0xffff)
+				cdbsz = MAX_SCSI_CDBSZ;
+			bsg_build_cdb(req->cdb, cdbsz, blocks, sd->pos, write_true,
+					fua);
+			bsg_prep(req, cdbsz, write_true, buf, blocks * sd->bs);
+
+			if (depth > 1 && write(sd->fd, &req->hdr,
+					sizeof(req->hdr)) == sizeof(req->hdr)) {
+				inflight++;
+			} else {
+				if (depth > 1 && bsg_unqueued(errno)) {
+					/* no queued io, go on one by one */
+					tperr("bsg: queued io %s, use depth 1\n",
+							strerror(errno));
+					queued = 0;
+					depth = 1;
+				} else if (depth > 1 && inflight) {
+					/* busy, retry once one is reaped */
+					slots[nfree++] = req - reqs;
+					break;
+				}
+				if (bsg_sync(sd, req, write_true) < 0)
+					ret = SD_ERR;
+				slots[nfree++] = req - reqs;
+			}
+			sd->pos += blocks;
+			buf += blocks * sd->bs;
+			n_blocks -= blocks;
+		}
+		if (!inflight)
+			break;
+
+		/* reap one, completions come in any order */
+		memset(&done, 0, sizeof(done));
+		done.guard = 'Q';
+		if (read(sd->fd, &done, sizeof(done)) != sizeof(done)) {
+			tperr("bsg: reaping: %s\n", strerror(errno));
+			bsg_drain(sd->fd, inflight);
+			sd->stat = SD_ERR_SGIO;
+			return SD_ERR;
+		}
+		req = (struct bsg_req *)(uintptr_t)done.usr_ptr;
+		memcpy(&req->hdr, &done, sizeof(done));
+		inflight--;
+		res = bsg_check(sd, req, write_true);
+		if (res == 2)
+			res = bsg_sync(sd, req, write_true);
+		if (res < 0)
+			ret = SD_ERR;
+		slots[nfree++] = req - reqs;
+	}
+	return ret;
+}
+
+static int read_bsg(struct sd_device *sd, void *buf, size_t size)
+{
+	return bsg_xfer(sd, buf, size, 0);
+}
+
+static int write_bsg(struct sd_device *sd, void *buf, size_t size)
+{
+	return bsg_xfer(sd, buf, size, 1);
+}
+
+static int seek_bsg(struct sd_device *sd, off_t offset)
+{
+	if ((offset + sd->bs * sd->parm->blocks) > sd->size)
+		offset = sd->size - sd->bs * sd->parm->blocks;
+	sd->pos = offset >> (sd_bitss(sd->bs));
+	return 0;
+}
+
+/* synchronize cache(10) of the whole device, no immed */
+static int flush_bsg(struct sd_device *sd)
+{
+	struct bsg_req req;
+
+	memset(&req, 0, sizeof(req));
+	req.cdb[0] = 0x35;
+	bsg_prep(&req, 10, 0, NULL, 0);
+	return bsg_sync(sd, &req, 1);
+}
+
+/* maximum transfer length of the block limits vpd page */
+static int maxget_bsg(struct sd_device *sd)
+{
+	struct bsg_req req;
+	unsigned char buf[64];
+	unsigned int mtl;
+
+	memset(&req, 0, sizeof(req));
+	memset(buf, 0, sizeof(buf));
+	req.cdb[0] = 0x12;	/* inquiry */
+	req.cdb[1] = 0x01;	/* evpd */
+	req.cdb[2] = 0xb0;	/* block limits */
+	req.cdb[4] = sizeof(buf);
+	bsg_prep(&req, 6, 0, buf, sizeof(buf));
+	if (bsg_sync(sd, &req, 0) < 0 || buf[1] != 0xb0) {
+		/* not every device has it, that's no test failure */
+		sd->stat = SD_ERR_NO;
+		return SD_ERR;
+	}
+	mtl = (buf[8] << 24) | (buf[9] << 16) | (buf[10] << 8) | buf[11];
+	if (mtl && (!sd->cmdmax || (long long)mtl * sd->bs < sd->cmdmax))
+		sd->cmdmax = mtl * sd->bs;
+	return SD_ERR_NO;
+}
+
+static int bsget_bsg(struct sd_device *sd)
+{
+	/* as 'bsget_sg', the real one is in the following blkget_bsg() */
+	return SD_ERR_NO;
+}
+
+static int blkget_bsg(struct sd_device *sd)
+{
+	struct bsg_req req;
+	unsigned char buf[32];
+	unsigned long long eb;
+	int k;
+
+	/* read capacity(16) first, old devices only have (10) */
+	memset(&req, 0, sizeof(req));
+	memset(buf, 0, sizeof(buf));
+	req.cdb[0] = 0x9e;	/* service action in(16) */
+	req.cdb[1] = 0x10;	/* read capacity(16) */
+	req.cdb[13] = sizeof(buf);
+	bsg_prep(&req, 16, 0, buf, sizeof(buf));
+	if (bsg_sync(sd, &req, 0) == 0) {
+		for (eb = 0, k = 0; k < 8; k++)
+			eb = (eb << 8) | buf[k];
+		sd->bs = (buf[8] << 24) | (buf[9] << 16) | (buf[10] << 8) | buf[11];
+		sd->pbs = sd->bs << (buf[13] & 0xf);
+		sd->align = ((buf[14] & 0x3f) << 8) | buf[15];
+	} else {
+		sd->stat = SD_ERR_NO;
+		memset(req.cdb, 0, sizeof(req.cdb));
+		memset(buf, 0, sizeof(buf));
+		req.cdb[0] = 0x25;
+		bsg_prep(&req, 10, 0, buf, 8);
+		if (bsg_sync(sd, &req, 0) < 0)
+			return SD_ERR;
+		eb = ((unsigned)buf[0] << 24) | (buf[1] << 16) 
+			| (buf[2] << 8) | buf[3];
+		sd->bs = (buf[4] << 24) | (buf[5] << 16) | (buf[6] << 8) | buf[7];
+		sd->pbs = sd->bs;
+	}
+
+	/* the total blocks is endblock + 1 */
+	sd->blk = eb + 1;
+	return SD_ERR_NO;
+}
+
+struct sd_device bsg_disk = {
+	.name	= BSG_DISK,
+	.seek	= seek_bsg,
+	.read	= read_bsg,
+	.write	= write_bsg,
+	.bsget	= bsget_bsg,
+	.blkget	= blkget_bsg,
+	.maxget	= maxget_bsg,
+	.flush	= flush_bsg,
+	.tests	= {
+		{ SEQU_WRC, },
+		{ RAND_WRC, },
+		{ BUTT_WRC, },
+		{ SEQU_READ, },
+		{ RAND_READ, },
+		{ BUTT_READ, },
+		{ SEQU_WRITE, },
+		{ RAND_WRITE, },
+		{ BUTT_WRITE, },
+		{ BUTT_SEEK, },
+	}
+};
@@ -0,0 +1,135 @@
+/* io_file.c
+ *
+ * Author: Xiang-Yu Wang <rain_wang@jabil.com>
+ *
+ * Copyright (c) 2008 Jabil, Inc.
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * 2026-10-19 derived from 'io_sd.c', made initial version. a regular file
+ *            on a filesystem is tested as a disk of its size, it can be
+ *            created and preallocated before the test
+ *            added 'flush_file' in
+ *            filesystem block size as the physical block
+ *
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "sdtest.h"
+#include "utils.h"
+
+static inline int lseek_file(struct sd_device *disk, off_t offset)
+{
+	return lseek(disk->fd, offset, SEEK_SET);
+}
+
+static inline int read_file(struct sd_device *disk, void *buf, size_t size)
+{
+	return read(disk->fd, buf, size);
+}
+
+static inline int write_file(struct sd_device *disk, void *buf, size_t size)
+{
+	return write(disk->fd, buf, size);
+}
+
+static inline int bsget_file(struct sd_device *disk)
+{
+	/* the filesystem hides the sectors, 512 aligns direct io anyway */
+	disk->bs = BASE_SEC_SIZE;
+	return 0;
+}
+
+static inline int blkget_file(struct sd_device *disk)
+{
+	struct stat st;
+
+	if (fstat(disk->fd, &st) < 0)
+		return -1;
+	disk->blk = st.st_size / disk->bs;
+	/* the filesystem block stands for the physical sector */
+	if (st.st_blksize > disk->bs)
+		disk->pbs = st.st_blksize;
+	return 0;
+}
+
+static int flush_file(struct sd_device *disk)
+{
+	if (disk->parm->sync == SD_SYNC_FSYNC)
+		return fsync(disk->fd);
+	return fdatasync(disk->fd);
+}
+
+/*
+ * create the file if it's missing and allocate it to size, files that
+ * are large enough are kept as they are
+ */
+int sd_fileprep(const char *name, off_t size)
+{
+	struct stat st;
+	int fd, res;
+
+	if ((fd = open(name, O_RDWR | O_CREAT, 0644)) < 0) {
+		tperr("%s: %s\n", name, strerror(errno));
+		return SD_ERR;
+	}
+	if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+		tperr("%s: not a regular file\n", name);
+		close(fd);
+		return SD_ERR;
+	}
+	if (st.st_size >= size) {
+		close(fd);
+		return SD_ERR_NO;
+	}
+
+	/* real blocks, so that the test doesn't measure the allocator */
+	res = fallocate(fd, 0, 0, size);
+	if (res < 0 && (errno == EOPNOTSUPP || errno == ENOSYS)) {
+		tperr("%s: no preallocation, file is sparse\n", name);
+		res = ftruncate(fd, size);
+	}
+	if (res < 0) {
+		tperr("%s: allocating %lld bytes: %s\n", name,
+				(long long)size, strerror(errno));
+		close(fd);
+		return SD_ERR;
+	}
+	close(fd);
+
+	return SD_ERR_NO;
+}
+
+struct sd_device file_disk = {
+	.name	= FILE_DISK,
+	.seek	= lseek_file,
+	.read	= read_file,
+	.write	= write_file,
+	.bsget	= bsget_file,
+	.blkget	= blkget_file,
+	.flush	= flush_file,
+	.tests	= {
+		{ SEQU_READ, },
+		{ RAND_READ, },
+		{ BUTT_READ, },
+		{ SEQU_WRITE, },
+		{ RAND_WRITE, },
+		{ BUTT_WRITE, },
+		{ SEQU_WRC, },
+		{ RAND_WRC, },
+		{ BUTT_WRC, },
+	}
+};
@@ -10,6 +10,9 @@
  *
  * 2008-01-04 made initial version
  * 2008-03-14 added 'bsget_sd' and 'blkget_sd' in
+ * 2026-10-19 added 'flush_sd' in
+ *            physical block size and alignment offset in 'bsget_sd'
+ *            added 'bseek' to the tests
  *
  */
 
@@ -39,11 +42,22 @@ static inline int write_sd(struct sd_device *disk, void *buf, size_t size)
 
 static inline int bsget_sd(struct sd_device *disk)
 {
+	unsigned int pbs;
+	int off;
+
 #ifdef BSZGET
-	return ioctl(disk->fd, BLKBSZGET, &disk->bs);
+	if (ioctl(disk->fd, BLKBSZGET, &disk->bs) < 0)
+		return -1;
 #else
-	return ioctl(disk->fd, BLKSSZGET, &disk->bs);
+	if (ioctl(disk->fd, BLKSSZGET, &disk->bs) < 0)
+		return -1;
 #endif
+	/* 512e drives, and partitions not starting on a physical sector */
+	if (ioctl(disk->fd, BLKPBSZGET, &pbs) == 0)
+		disk->pbs = pbs;
+	if (ioctl(disk->fd, BLKALIGNOFF, &off) == 0 && off > 0)
+		disk->align = off / disk->bs;
+	return 0;
 }
 
 static inline int blkget_sd(struct sd_device *disk)
@@ -51,6 +65,14 @@ static inline int blkget_sd(struct sd_device *disk)
 	return ioctl(disk->fd, BLKGETSIZE, &disk->blk);
 }
 
+static int flush_sd(struct sd_device *disk)
+{
+	/* the block layer sends a cache flush to the device for both */
+	if (disk->parm->sync == SD_SYNC_FSYNC)
+		return fsync(disk->fd);
+	return fdatasync(disk->fd);
+}
+
 struct sd_device gen_disk = {
 	.name	= GENERIC_DISK,
 	.seek	= lseek_sd,
@@ -58,6 +80,7 @@ struct sd_device gen_disk = {
 	.write	= write_sd,
 	.bsget	= bsget_sd,
 	.blkget	= blkget_sd,
+	.flush	= flush_sd,
 	.tests	= {
 		{ SEQU_READ, },
 		{ RAND_READ, },
@@ -68,5 +91,6 @@ struct sd_device gen_disk = {
 		{ SEQU_WRC, },
 		{ RAND_WRC, },
 		{ BUTT_WRC, },
+		{ BUTT_SEEK, },
 	}
 };
@@ -18,6 +18,12 @@
  * 2008-03-14 added 'bsget_sg' and 'blkget_sg' in
  * 2008-06-11 tuned the buffer size in 'interf' test to 128k to fit various
  *            types of hard drives we tested.
+ * 2026-10-19 added mmap-ed reserved buffer and direct io transfer modes in
+ *            'read_sg' and 'write_sg', 'bufget_sg' and 'bufput_sg' in
+ *            fua writes of sync modes in 'write_sg', 'flush_sg' in
+ *            'maxget_sg' in, transfers are split into commands of 'cmdmax'
+ *            read capacity(16) in 'blkget_sg' with the physical block and
+ *            alignment, 10 or 16 byte commands chosen per command
  *
  */
 
@@ -57,6 +63,14 @@ static int verbose = 0;
 static int pack_id_count = 0;
 static int sum_of_resids = 0;
 
+/* mmap-ed sg reserved buffer, set up once by 'bufget_sg' */
+static char *sg_mmap_buf = NULL;
+static size_t sg_mmap_len = 0;
+
+/* transfers asked for direct io and those the driver fell back */
+static int dio_total = 0;
+static int dio_incomplete = 0;
+
 #define BPI (signed)(sizeof(int))
 
 #define RB_MODE_DESC 3
@@ -160,6 +174,14 @@ static int sg_build_scsi_cdb(unsigned char *cdbp, int cdb_sz,
 	return 0;
 }
 
+/* 10 byte commands as long as lba and length fit, 16 byte beyond 2T */
+static inline int sg_cdbsz(long long from_block, int blocks)
+{
+	if ((from_block + blocks) > 0xffffffffLL || blocks > 0xffff)
+		return MAX_SCSI_CDBSZ;
+	return DEF_SCSI_CDBSZ;
+}
+
 /* -3 medium/hardware error, -2 -> not ready, 0 -> successful,
    1 -> recoverable (ENOMEM), 2 -> try again (e.g. unit attention),
    3 -> try again (e.g. aborted command), -1 -> other unrecoverable error */
@@ -342,28 +364,35 @@ static int sg_bwrite(int sg_fd, unsigned char *buff, int blocks,
 
 static int read_sg(struct sd_device *sd, void *buf, size_t size)
 {
-        int do_dio = 0;
-        int do_mmap = 0;
+        int do_dio = (sd->parm->xfer == SD_XFER_DIO);
+        int do_mmap = (sd->parm->xfer == SD_XFER_MMAP) && sg_mmap_buf;
         int no_dxfer = 0;
         int fua = 0;
         int dpo = 0;
         int scsi_cdbsz = DEF_SCSI_CDBSZ;
-        int dio_incomplete = 0;
         int res, buf_sz, dio_tmp, i;
         int n_blocks, blocks, blocks_per;
+        unsigned char *ptr = buf;
 	int ret = SD_ERR_NO;
 
 		n_blocks = size / sd->bs + ((size % sd->bs) ? 1 : 0);
         blocks_per = sd->parm->blocks;
+	if (sd->cmdmax && blocks_per * sd->bs > sd->cmdmax)
+		blocks_per = sd->cmdmax / sd->bs;
+
+	/* every command goes through the mmap-ed reserved buffer */
+	if (do_mmap && blocks_per * sd->bs > sg_mmap_len)
+		blocks_per = sg_mmap_len / sd->bs;
 
         for (i = 0; n_blocks != 0; ++i) {
                 if (n_blocks < 0)
                 	blocks = 0;
                 else
                 	blocks = (n_blocks > blocks_per) ? blocks_per : n_blocks;
+		scsi_cdbsz = sg_cdbsz(sd->pos, blocks);
 				
                 dio_tmp = do_dio;
-                res = sg_bread(sd->fd, buf, blocks, sd->pos, sd->bs, scsi_cdbsz, fua, dpo, &dio_tmp, do_mmap, no_dxfer);
+                res = sg_bread(sd->fd, ptr, blocks, sd->pos, sd->bs, scsi_cdbsz, fua, dpo, &dio_tmp, do_mmap, no_dxfer);
                 if (1 == res) {     /* ENOMEM, find what's available+try that */
                        	if (ioctl(sd->fd, SG_GET_RESERVED_SIZE, &buf_sz) < 0) {
                        		perror("RESERVED_SIZE ioctls failed");
@@ -373,11 +402,12 @@ static int read_sg(struct sd_device *sd, void *buf, size_t size)
                        		buf_sz = MIN_RESERVED_SIZE;
                 	blocks_per = (buf_sz + sd->bs - 1) / sd->bs;
                 	blocks = blocks_per;
+			scsi_cdbsz = sg_cdbsz(sd->pos, blocks);
                 	tperr("Reducing read to %d blocks per loop\n", blocks_per);
-                	res = sg_bread(sd->fd, buf, blocks, sd->pos, sd->bs, scsi_cdbsz, fua, dpo, &dio_tmp, do_mmap, no_dxfer);
+                	res = sg_bread(sd->fd, ptr, blocks, sd->pos, sd->bs, scsi_cdbsz, fua, dpo, &dio_tmp, do_mmap, no_dxfer);
                 } else if (2 == res) {
                 	tperr("Unit attention, try again (r)\n");
-                       	res = sg_bread(sd->fd, buf, blocks, sd->pos, sd->bs, scsi_cdbsz, fua, dpo, &dio_tmp, do_mmap, no_dxfer);
+                       	res = sg_bread(sd->fd, ptr, blocks, sd->pos, sd->bs, scsi_cdbsz, fua, dpo, &dio_tmp, do_mmap, no_dxfer);
                	}
                 if (0 != res) {
 						ret = SD_ERR;
@@ -407,10 +437,16 @@ static int read_sg(struct sd_device *sd, void *buf, size_t size)
 						sd->stat = SD_ERR_SGIO;
                 	break;
                 } else {
-                       	if (do_dio && (0 == dio_tmp))
-                       		dio_incomplete++;
+                       	if (do_dio) {
+                       		dio_total++;
+                       		if (0 == dio_tmp)
+                       			dio_incomplete++;
+                       	}
+                       	if (do_mmap && ptr != (unsigned char *)sg_mmap_buf)
+                       		memcpy(ptr, sg_mmap_buf, blocks * sd->bs);
                 }
 				sd->pos += blocks;
+				ptr += blocks * sd->bs;
 				
                 if (n_blocks > 0)
                 	n_blocks -= blocks;
@@ -422,27 +458,37 @@ static int read_sg(struct sd_device *sd, void *buf, size_t size)
 
 static int write_sg(struct sd_device *sd, void *buf, size_t size)
 {
-        int do_dio = 0;
-        int do_mmap = 0;
+        int do_dio = (sd->parm->xfer == SD_XFER_DIO);
+        int do_mmap = (sd->parm->xfer == SD_XFER_MMAP) && sg_mmap_buf;
         int no_dxfer = 0;
-        int fua = 0;
+        int fua = (sd->parm->sync == SD_SYNC_DSYNC
+			|| sd->parm->sync == SD_SYNC_FUA);
         int dpo = 0;
         int scsi_cdbsz = DEF_SCSI_CDBSZ;
-        int dio_incomplete = 0;
         int res, buf_sz, dio_tmp, i;
         int n_blocks, blocks, blocks_per;
+        unsigned char *ptr = buf;
 	int ret = SD_ERR_NO;
 
 	n_blocks = size / sd->bs + ((size % sd->bs) ? 1 : 0);
         blocks_per = sd->parm->blocks;
+	if (sd->cmdmax && blocks_per * sd->bs > sd->cmdmax)
+		blocks_per = sd->cmdmax / sd->bs;
+
+	/* every command goes through the mmap-ed reserved buffer */
+	if (do_mmap && blocks_per * sd->bs > sg_mmap_len)
+		blocks_per = sg_mmap_len / sd->bs;
 
         for (i = 0; n_blocks != 0; ++i) {
                 if (n_blocks < 0)
                 	blocks = 0;
                 else
                 	blocks = (n_blocks > blocks_per) ? blocks_per : n_blocks;
+		scsi_cdbsz = sg_cdbsz(sd->pos, blocks);
                 dio_tmp = do_dio;
-                res = sg_bwrite(sd->fd, buf, blocks, sd->pos, sd->bs, scsi_cdbsz, fua, dpo, &dio_tmp, do_mmap, no_dxfer);
+                if (do_mmap && ptr != (unsigned char *)sg_mmap_buf)
+                       	memcpy(sg_mmap_buf, ptr, blocks * sd->bs);
+                res = sg_bwrite(sd->fd, ptr, blocks, sd->pos, sd->bs, scsi_cdbsz, fua, dpo, &dio_tmp, do_mmap, no_dxfer);
                 if (1 == res) {     /* ENOMEM, find what's available+try that */
                        	if (ioctl(sd->fd, SG_GET_RESERVED_SIZE, &buf_sz) < 0) {
                        		perror("RESERVED_SIZE ioctls failed");
@@ -452,11 +498,12 @@ static int write_sg(struct sd_device *sd, void *buf, size_t size)
                        		buf_sz = MIN_RESERVED_SIZE;
                        	blocks_per = (buf_sz + sd->bs - 1) / sd->bs;
                        	blocks = blocks_per;
+			scsi_cdbsz = sg_cdbsz(sd->pos, blocks);
                        	tperr("Reducing write to %d blocks per loop\n", blocks_per);
-                	res = sg_bwrite(sd->fd, buf, blocks, sd->pos, sd->bs, scsi_cdbsz, fua, dpo, &dio_tmp, do_mmap, no_dxfer);
+                	res = sg_bwrite(sd->fd, ptr, blocks, sd->pos, sd->bs, scsi_cdbsz, fua, dpo, &dio_tmp, do_mmap, no_dxfer);
                 } else if (2 == res) {
                        	tperr("Unit attention, try again (w)\n");
-                       	res = sg_bwrite(sd->fd, buf, blocks, sd->pos, sd->bs, scsi_cdbsz, fua, dpo, &dio_tmp, do_mmap, no_dxfer);
+                       	res = sg_bwrite(sd->fd, ptr, blocks, sd->pos, sd->bs, scsi_cdbsz, fua, dpo, &dio_tmp, do_mmap, no_dxfer);
                 }
                 if (0 != res) {
 			ret = SD_ERR;
@@ -486,10 +533,14 @@ static int write_sg(struct sd_device *sd, void *buf, size_t size)
 			sd->stat = SD_ERR_SGIO;
                        	break;
                 } else {
-                       	if (do_dio && (0 == dio_tmp))
-                       		dio_incomplete++;
+                       	if (do_dio) {
+                       		dio_total++;
+                       		if (0 == dio_tmp)
+                       			dio_incomplete++;
+                       	}
                 }
 		sd->pos += blocks;
+		ptr += blocks * sd->bs;
                 if (n_blocks > 0)
                 	n_blocks -= blocks;
                 else if (n_blocks < 0)
@@ -958,6 +1009,38 @@ err_out:
         return (sd->stat == SD_ERR_NO) ? ret : SD_ERR;
 }
 
+/* synchronize cache(10) of the whole device, no immed */
+static int flush_sg(struct sd_device *sd)
+{
+	int res;
+
+	res = sg_ll_sync_cache_10(sd->fd, 0, 0, 0, 0, 0, 1, 0);
+	if (SG_LIB_CAT_UNIT_ATTENTION == res)
+		res = sg_ll_sync_cache_10(sd->fd, 0, 0, 0, 0, 0, 1, 0);
+	if (0 != res) {
+		tperr("SYNCHRONIZE CACHE failed\n");
+		sd->stat = SD_ERR_SGIO;
+		return SD_ERR;
+	}
+	return SD_ERR_NO;
+}
+
+/* maximum transfer length of the block limits vpd page */
+static int maxget_sg(struct sd_device *sd)
+{
+	unsigned char buf[64];
+	unsigned int mtl;
+
+	memset(buf, 0, sizeof(buf));
+	if (sg_ll_inquiry(sd->fd, 0, 1, 0xb0, buf, sizeof(buf), 0, 0)
+			|| buf[1] != 0xb0)
+		return SD_ERR;
+	mtl = (buf[8] << 24) | (buf[9] << 16) | (buf[10] << 8) | buf[11];
+	if (mtl && (!sd->cmdmax || (long long)mtl * sd->bs < sd->cmdmax))
+		sd->cmdmax = mtl * sd->bs;
+	return SD_ERR_NO;
+}
+
 static int bsget_sg(struct sd_device *sd)
 {
 	/*
@@ -969,41 +1052,95 @@ static int bsget_sg(struct sd_device *sd)
 
 static int blkget_sg(struct sd_device *sd)
 {
-	struct sg_io_hdr *hdr = malloc(sizeof(*hdr));
-	unsigned char buf[8], cdb[16];
-	size_t eb = 0;
-	int bs = 0;
+	unsigned char buf[32];
+	unsigned long long eb;
+	int k, res;
 
-	memset(hdr, 0, sizeof(*hdr));
-	memset(cdb, 0, sizeof(cdb));
+	/* read capacity(16) first, old devices and cd-roms only have (10) */
 	memset(buf, 0, sizeof(buf));
+	res = sg_ll_readcap_16(sd->fd, 0, 0, buf, sizeof(buf), 0, 0);
+	if (0 == res) {
+		for (eb = 0, k = 0; k < 8; k++)
+			eb = (eb << 8) | buf[k];
+		sd->bs = (buf[8] << 24) | (buf[9] << 16) | (buf[10] << 8) | buf[11];
+		/* logical blocks per physical block exponent */
+		sd->pbs = sd->bs << (buf[13] & 0xf);
+		sd->align = ((buf[14] & 0x3f) << 8) | buf[15];
+	} else {
+		memset(buf, 0, sizeof(buf));
+		res = sg_ll_readcap_10(sd->fd, 0, 0, buf, 8, 1, 0);
+		if (0 != res) {
+			tperr("read capacity failed\n");
+			sd->stat = SD_ERR_SYS;
+			return SD_ERR;
+		}
+		eb = ((unsigned)buf[0] << 24) | (buf[1] << 16) 
+			| (buf[2] << 8) | buf[3];
+		sd->bs = (buf[4] << 24) | (buf[5] << 16) | (buf[6] << 8) | buf[7];
+		sd->pbs = sd->bs;
+		sd->align = 0;
+		if (eb == 0xffffffffULL)
+			tperr("read capacity(16) failed, size limited to 2T\n");
+	}
+	sd_debug("end block %llu bs %d pbs %d\n", eb, sd->bs, sd->pbs);
 
-	hdr->interface_id = 'S';
-	hdr->cmd_len = sizeof(cdb);
-	hdr->dxfer_direction = SG_DXFER_FROM_DEV;
-	hdr->dxferp = buf;
-	hdr->dxfer_len = sizeof(buf);
+	/* the total blocks is endblock + 1 */
+	sd->blk = eb + 1;
+	return SD_ERR_NO;
+}
 
-	hdr->cmdp = cdb;
-	hdr->cmdp[0] = GPCMD_READ_CDVD_CAPACITY;
+static char *bufget_sg(struct sd_device *sd, size_t size)
+{
+	int rsz = size;
+	char *p;
 
-	if (ioctl(sd->fd, SG_IO, hdr) < 0) {
-		tperr("read capacity: %s\n", strerror(errno));
-		tperr("sense key: %x\n", hdr->status);
-		sd->stat = SD_ERR_SYS;
-		return SD_ERR;
+	if (sd->parm->xfer != SD_XFER_MMAP)
+		return NULL;
+
+	/* mmap the reserved buffer once, reuse it for the following passes */
+	if (sg_mmap_buf && size <= sg_mmap_len)
+		return sg_mmap_buf;
+
+	if (ioctl(sd->fd, SG_SET_RESERVED_SIZE, &rsz) < 0
+			|| ioctl(sd->fd, SG_GET_RESERVED_SIZE, &rsz) < 0) {
+		tperr("reserved buffer: %s\n", strerror(errno));
+		goto fallback;
+	}
+	if (rsz < size) {
+		tperr("reserved buffer: only %d of %ld bytes\n", rsz, (long)size);
+		goto fallback;
 	}
 
-	eb = (buf[0] << 24) | (buf[1] << 16) | (buf[2] << 8) | buf[3];
-	if (!eb)
-		eb = ~0UL;
+	p = mmap(NULL, rsz, PROT_READ | PROT_WRITE, MAP_SHARED, sd->fd, 0);
+	if (p == MAP_FAILED) {
+		tperr("mmap reserved buffer: %s\n", strerror(errno));
+		goto fallback;
+	}
+	sd_debug("mmap-ed %d bytes reserved buffer\n", rsz);
+
+	sg_mmap_buf = p;
+	sg_mmap_len = rsz;
+	return sg_mmap_buf;
+fallback:
+	/* e.g. block device node, go on with indirect io */
+	tperr("mmap io not available, use indirect io\n");
+	sd->parm->xfer = SD_XFER_COPY;
+	return NULL;
+}
 
-	bs = (buf[4] << 24) | (buf[5] << 16) | (buf[6] << 8) | buf[7];
-	
-	/* the total blocks is endblock + 1 */
-	sd->bs = bs;
-	sd->blk = eb + 1;
-	return SD_ERR_NO;
+static void bufput_sg(struct sd_device *sd, char *buf, size_t size)
+{
+	if (sg_mmap_buf && buf == sg_mmap_buf) {
+		munmap(sg_mmap_buf, sg_mmap_len);
+		sg_mmap_buf = NULL;
+		sg_mmap_len = 0;
+	}
+
+	if (dio_total && sd->parm->nopro < 2)
+		tpout("\ndirect io: %d of %d transfers fell back to indirect io\n",
+				dio_incomplete, dio_total);
+	dio_total = 0;
+	dio_incomplete = 0;
 }
 
 struct sd_device sd_disk = {
@@ -1013,6 +1150,10 @@ struct sd_device sd_disk = {
 	.write	= write_sg,
 	.bsget	= bsget_sg,
 	.blkget	= blkget_sg,
+	.maxget	= maxget_sg,
+	.bufget	= bufget_sg,
+	.bufput	= bufput_sg,
+	.flush	= flush_sg,
 	.tests	= {
 		{ SEQU_WRC, },
 		{ RAND_WRC, },
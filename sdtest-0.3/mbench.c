@@ -0,0 +1,153 @@
+/* mbench.c
+ *
+ * Author: Xiang-Yu Wang <rain_wang@jabil.com>
+ *
+ * Copyright (c) 2008 Jabil, Inc.
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * 2026-10-19 made initial version, times the cpu side of every transfer
+ *            in isolation: pattern fill and compare of the algorithms,
+ *            'sd_randget', the interface test buffer fill and checksum
+ *            and the progress percentage, in ns/op and GB/s
+ *
+ * usage: mbench [transfer size], e.g. mbench 64k
+ */
+
+/* the static helpers of the interface test are timed in place */
+#include "io_sg.c"
+
+#include <fcntl.h>
+
+#define MB_SIZE		(64 * 1024)
+#define MB_MIN_NS	200000000ULL	/* run every item this long at least */
+
+static char *mb_buf;
+static int mb_len;
+static volatile int mb_sink;
+static FILE *mb_out;		/* the report, stdout is /dev/null */
+
+static unsigned long long mb_nsec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void mb_patfill(void)
+{
+	sd_patfill(mb_buf, mb_len, 0x5a5a5a5a);
+}
+
+static void mb_patcmp(void)
+{
+	mb_sink += sd_patcmp(mb_buf, mb_len, 0x5a5a5a5a);
+}
+
+static void mb_randget(void)
+{
+	mb_sink += sd_randget(1LL << 40);
+}
+
+static void mb_fillbuf(void)
+{
+	do_fill_buffer((int *)mb_buf, mb_len);
+}
+
+static void mb_checksum(void)
+{
+	mb_sink += do_checksum((int *)mb_buf, mb_len, 1);
+}
+
+static void mb_progress(void)
+{
+	static long n = 0;
+
+	tpout("%3ld%%\b\b\b\b", n++ % 100);
+}
+
+struct mb_item {
+	const char *	name;
+	void (*func)(void);
+	void (*prep)(void);
+	int		bytes;	/* data touched per op, 0 for none */
+};
+
+static void mb_run(struct mb_item *it)
+{
+	unsigned long long n, i, t0, t;
+
+	if (it->prep)
+		it->prep();
+	/* double the ops until the run is long enough to trust */
+	for (n = 1; ; n *= 2) {
+		t0 = mb_nsec();
+		for (i = 0; i < n; i++)
+			it->func();
+		t = mb_nsec() - t0;
+		if (t >= MB_MIN_NS)
+			break;
+	}
+	fflush(stdout);
+
+	tprintf(mb_out, "%-24s %8d %12.1f", it->name, it->bytes, (double)t / n);
+	if (it->bytes)
+		tprintf(mb_out, " %10.2f\n", (double)it->bytes * n / t);
+	else
+		tprintf(mb_out, " %10s\n", "-");
+}
+
+int main(int argc, char **argv)
+{
+	struct mb_item items[] = {
+		{ "pattern fill",	mb_patfill,	NULL,		0 },
+		{ "pattern compare",	mb_patcmp,	mb_patfill,	0 },
+		{ "sd_randget",		mb_randget,	NULL,		0 },
+		{ "do_fill_buffer",	mb_fillbuf,	NULL,		0 },
+		{ "do_checksum",	mb_checksum,	mb_fillbuf,	0 },
+		{ "progress tpout",	mb_progress,	NULL,		0 },
+		{ NULL, },
+	};
+	struct mb_item *it;
+	int out, null;
+
+	mb_len = (argc > 1) ? sd_bytebox(argv[1], BASE_SEC_SIZE) : MB_SIZE;
+	if (mb_len <= 0 || mb_len % 4) {
+		tperr("usage: %s [transfer size, a multiple of 4]\n", argv[0]);
+		exit(SD_ERR_USR);
+	}
+	if (posix_memalign((void **)&mb_buf, 4096, mb_len)) {
+		tperr("not enough user memory\n");
+		exit(SD_ERR_SYS);
+	}
+	memset(mb_buf, 0, mb_len);
+	if (sd_randinit())
+		exit(SD_ERR_SYS);
+	for (it = items; it->name; it++)
+		if (it->func != mb_randget && it->func != mb_progress)
+			it->bytes = mb_len;
+
+	/* the progress goes to a terminal or log, time the formatting only */
+	out = dup(STDOUT_FILENO);
+	null = open("/dev/null", O_WRONLY);
+	if (out < 0 || null < 0 || !(mb_out = fdopen(out, "w"))
+			|| dup2(null, STDOUT_FILENO) < 0) {
+		tperr("/dev/null: %s\n", strerror(errno));
+		exit(SD_ERR_SYS);
+	}
+	close(null);
+
+	tprintf(mb_out, "%-24s %8s %12s %10s\n", "item", "bytes", "ns/op", "GB/s");
+	for (it = items; it->name; it++) {
+		mb_run(it);
+		fflush(mb_out);
+	}
+
+	fclose(mb_out);
+	free(mb_buf);
+
+	return mb_sink == 0x7fffffff;
+}
@@ -0,0 +1,95 @@
+/* pace.c
+ *
+ * Author: Xiang-Yu Wang <rain_wang@jabil.com>
+ *
+ * Copyright (c) 2008 Jabil, Inc.
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * 2026-10-19 made initial version, every transfer of any thread takes
+ *            the next slot of one schedule and sleeps till it, a device
+ *            falling behind the schedule doesn't get a burst afterwards
+ *
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include <errno.h>
+#include <sys/types.h>
+
+#include "sdtest.h"
+#include "utils.h"
+#include "pace.h"
+
+/* slots missed by more than this are dropped, in nsec */
+#define PACE_SLACK	10000000ULL
+
+/* the hooks being paced */
+static int (*io_read)(struct sd_device *, void *, size_t);
+static int (*io_write)(struct sd_device *, void *, size_t);
+
+/* nsec between the transfers of all threads, 0 for none */
+static volatile unsigned long long pace_gap = 0;
+/* nsec of the next free slot */
+static volatile unsigned long long pace_next = 0;
+
+static unsigned long long pace_nsec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void pace_wait(void)
+{
+	unsigned long long gap = pace_gap, now, slot;
+	struct timespec ts;
+
+	if (!gap)
+		return;
+	now = pace_nsec();
+	slot = __sync_fetch_and_add(&pace_next, gap);
+	if (slot + PACE_SLACK < now) {
+		/* behind the schedule, restart it from now */
+		__sync_bool_compare_and_swap(&pace_next, slot + gap, now + gap);
+		return;
+	}
+	if (slot <= now)
+		return;
+	ts.tv_sec = slot / 1000000000ULL;
+	ts.tv_nsec = slot % 1000000000ULL;
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+		;
+}
+
+static int pa_read(struct sd_device *sd, void *buf, size_t size)
+{
+	pace_wait();
+	return io_read(sd, buf, size);
+}
+
+static int pa_write(struct sd_device *sd, void *buf, size_t size)
+{
+	pace_wait();
+	return io_write(sd, buf, size);
+}
+
+void sd_pacerate(unsigned long long rate)
+{
+	pace_gap = rate ? 1000000000ULL / rate : 0;
+	/* the first transfer restarts the schedule */
+	pace_next = 0;
+}
+
+void sd_pacewrap(struct sd_device *disk)
+{
+	if (disk->read == pa_read)
+		return;
+	io_read = disk->read;
+	io_write = disk->write;
+	disk->read = pa_read;
+	disk->write = pa_write;
+}
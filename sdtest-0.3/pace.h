@@ -0,0 +1,29 @@
+/* pace.h
+ *
+ * Author: Xiang-Yu Wang <rain_wang@jabil.com>
+ *
+ * Copyright (c) 2008 Jabil, Inc.
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * 2026-10-19 made initial version
+ *
+ */
+
+#ifndef PACE_H
+#define PACE_H
+
+#include "sdtest.h"
+
+/*
+ * pace the transfers through the read and write hooks of the device
+ * at a rate of transfers per second shared by all threads
+ */
+extern void sd_pacewrap(struct sd_device *);
+
+/* transfers per second from now on, 0 for no pacing */
+extern void sd_pacerate(unsigned long long);
+
+#endif /* PACE_H */
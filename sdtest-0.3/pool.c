@@ -0,0 +1,161 @@
+/* pool.c
+ *
+ * Author: Xiang-Yu Wang <rain_wang@jabil.com>
+ *
+ * Copyright (c) 2008 Jabil, Inc.
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * 2026-10-19 made initial version, the data and backup buffers of all
+ *            passes and threads come from one mapping made before the
+ *            test, page aligned for direct io, optionally on huge pages
+ *
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/mman.h>
+
+#include "sdtest.h"
+#include "utils.h"
+#include "cpus.h"
+#include "pool.h"
+
+/* huge page size if /proc/meminfo doesn't tell */
+#define DEF_HPAGE	(2 * 1024 * 1024)
+
+static struct sd_pool {
+	pthread_mutex_t	lock;
+
+	char *		map;	/* the mapping */
+	size_t		len;	/* length of the mapping */
+	size_t		size;	/* size of every buffer, page aligned */
+
+	char **		free;	/* stack of free buffers */
+	int		nfree;
+} pool = {
+	.lock	= PTHREAD_MUTEX_INITIALIZER,
+};
+
+static size_t sd_hpagesize(void)
+{
+	char line[128];
+	size_t kb, sz = DEF_HPAGE;
+	FILE *fp;
+
+	if (!(fp = fopen("/proc/meminfo", "r")))
+		return sz;
+	while (fgets(line, sizeof(line), fp)) {
+		if (sscanf(line, "Hugepagesize: %zu kB", &kb) == 1) {
+			sz = kb * 1024;
+			break;
+		}
+	}
+	fclose(fp);
+
+	return sz;
+}
+
+int sd_poolinit(size_t size, int count, int node, int huge)
+{
+	size_t psz = getpagesize(), hsz = 0, len;
+	char *map = MAP_FAILED, *base;
+	int i;
+
+	size = (size + psz - 1) & ~(psz - 1);
+	len = size * count;
+
+	if (huge) {
+		hsz = sd_hpagesize();
+		len = (len + hsz - 1) & ~(hsz - 1);
+		map = mmap(NULL, len, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (map == MAP_FAILED)
+			tperr("huge: no hugetlb pages (%s), use transparent "
+					"huge pages\n", strerror(errno));
+	}
+	base = map;
+	if (map == MAP_FAILED) {
+		/* transparent huge pages want an aligned area */
+		map = mmap(NULL, len + hsz, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (map == MAP_FAILED) {
+			tperr("not enough user memory for buffer pool\n");
+			return SD_ERR;
+		}
+		base = map;
+		if (huge) {
+			base = (char *)(((unsigned long)map + hsz - 1) 
+					& ~(hsz - 1));
+			if (madvise(base, len, MADV_HUGEPAGE) < 0)
+				sd_debug("madvise: %s\n", strerror(errno));
+		}
+		len += hsz;
+	}
+
+	pool.free = (char **)malloc(count * sizeof(char *));
+	if (!pool.free) {
+		munmap(map, len);
+		tperr("not enough user memory\n");
+		return SD_ERR;
+	}
+	pool.map  = map;
+	pool.len  = len;
+	pool.size = size;
+
+	if (node >= 0)
+		sd_nodebind(base, size * count, node);
+	/* fault the pages in now, not in the test */
+	memset(base, 0, size * count);
+
+	for (i = 0; i < count; i++)
+		pool.free[i] = base + (size_t)i * size;
+	pool.nfree = count;
+	sd_debug("pool: %d buffers of %zu bytes\n", count, size);
+
+	return SD_ERR_NO;
+}
+
+void sd_poolexit(void)
+{
+	if (pool.map)
+		munmap(pool.map, pool.len);
+	free(pool.free);
+	pool.map = NULL;
+	pool.free = NULL;
+	pool.nfree = 0;
+}
+
+char *sd_poolget(void)
+{
+	char *buf = NULL;
+
+	pthread_mutex_lock(&pool.lock);
+	if (pool.nfree)
+		buf = pool.free[--pool.nfree];
+	pthread_mutex_unlock(&pool.lock);
+	if (!buf)
+		tperr("buffer pool exhausted\n");
+
+	return buf;
+}
+
+void sd_poolput(char *buf)
+{
+	if (!buf)
+		return;
+	pthread_mutex_lock(&pool.lock);
+	pool.free[pool.nfree++] = buf;
+	pthread_mutex_unlock(&pool.lock);
+}
@@ -0,0 +1,34 @@
+/* pool.h
+ *
+ * Author: Xiang-Yu Wang <rain_wang@jabil.com>
+ *
+ * Copyright (c) 2008 Jabil, Inc.
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * 2026-10-19 made initial version
+ *
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <sys/types.h>
+
+/* buffers of a test: data and backup per thread */
+#define POOL_BUFS	2
+
+/* 
+ * map the pool once: count page aligned buffers of size bytes, on the
+ * numa node (-1 for any), backed by huge pages if huge is set
+ */
+extern int sd_poolinit(size_t, int, int, int);
+extern void sd_poolexit(void);
+
+/* get and put back a buffer of the pool */
+extern char *sd_poolget(void);
+extern void sd_poolput(char *);
+
+#endif /* POOL_H */
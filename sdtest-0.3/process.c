@@ -17,6 +17,13 @@
  * 2008-06-10 move the 'selfd' test out of main loop, for this test should
  *            only be issued once for every device.
  * 2008-06-12 fixed a bug, test string in process should be preset.
+ * 2026-10-19 status board in shared memory, every sdtest child publishes
+ *            its progress into a slot, shown as one refreshing table by
+ *            the main thread, '-m' option for the refresh interval.
+ * 2026-10-19 threads claim the next slice of the device for every sdtest
+ *            run instead of testing a fixed piece, every test has its own
+ *            cursor so each slice is tested in turn by whichever thread
+ *            is free.
  *
  */
 
@@ -37,6 +44,7 @@
 
 #include "sdtest.h"
 #include "utils.h"
+#include "board.h"
 
 enum test_item_error_code {
 	SEQ_READ_ERR	= 0x01,
@@ -94,6 +102,8 @@ struct process_parm {
 struct process_data {
 	pthread_t thread;
 	pthread_attr_t attr;
+	int 	ind;
+	int 	done;
 	int 	pid;
 	int 	sigs;
 	int 	res;
@@ -107,6 +117,86 @@ static struct process_data process[NUM_THREADS];
 
 static int part_test_device = 1;
 
+/* slices of the device claimed by threads, per thread */
+#define PROC_SLICES	4
+
+static off_t slice_dev;
+static off_t slice_size;
+static unsigned long slices;
+static unsigned long slice_next[9];	/* cursor of every test item */
+
+static void pclaim(struct process_data *d, int i)
+{
+	unsigned long k;
+
+	k = __sync_fetch_and_add(&slice_next[i], 1) % slices;
+	d->start = slice_size * k;
+	/* the last one takes the remainder */
+	d->size = (k == slices - 1) ? slice_dev - d->start : slice_size;
+}
+
+/* the status board and its name */
+static struct sd_board *board = NULL;
+static char bname[64];
+
+static const char *bstate[] = {
+	"idle",
+	"run",
+	"pass",
+	"FAIL",
+};
+
+/* let the child publish to its slot, the table replaces its output */
+static void pboard(char *cmd, struct process_data *d)
+{
+	if (!board)
+		return;
+	sprintf(cmd + strlen(cmd), " -B %s:%d >/dev/null", bname, d->ind);
+}
+
+/* count the result of a child, also when it didn't get to publish */
+static void presult(struct process_data *d, const char *test, int res)
+{
+	struct sd_slot s;
+
+	if (!board)
+		return;
+	sd_boardget(&board->slot[d->ind], &s);
+	if (res)
+		s.failed++;
+	else
+		s.passed++;
+	snprintf(s.test, sizeof(s.test), "%s", test);
+	s.state = res ? BD_FAIL : BD_PASS;
+	s.res = res;
+	sd_boardput(&board->slot[d->ind], &s);
+}
+
+static void prender(int n, int redraw)
+{
+	struct sd_slot s;
+	unsigned long long pct;
+	int i;
+
+	if (redraw)
+		tpout("\033[%dA", n + 1);
+	tpout("%-4s %-12s %-13s %-7s %-5s %4s %7s %6s %12s %6s %7s\033[K\n",
+			"slot", "device", "range(MB)", "test", "state", "done",
+			"MB/s", "errors", "lba", "secs", "pass/f");
+	for (i = 0; i < n; i++) {
+		sd_boardget(&board->slot[i], &s);
+		pct = s.expect ? s.bytes * 100 / s.expect : 0;
+		if (pct > 100)
+			pct = 100;
+		tpout("%-4d %-12s %6llu-%-6llu %-7s %-5s %3llu%% %7u %6llu "
+				"%12llu %6u %3u/%-3u\033[K\n", i, s.device,
+				s.start >> 20, (s.start + s.size) >> 20, s.test,
+				bstate[s.state & 3], pct, s.mbps, s.errs, s.lba,
+				s.secs, s.passed, s.failed);
+	}
+	fflush(stdout);
+}
+
 static void psig(int sig)
 {
 	tperr("ptest interrupted (%s)\n", strsignal(sig));
@@ -135,8 +225,9 @@ static void *ptest(void *parm)
 			 * for (i = 0; item[i]; i++) {
 			 */
 			for (i = 2; item[i]; i++) {
-				char cmd[128];
+				char cmd[256];
 				if (part_test_device) {
+					pclaim(d, i);
 					if (p->opts)
 						sprintf(cmd, 
 						"%s -d %s -t %s %s -q 2 -s %lld -f %lld", 
@@ -158,12 +249,14 @@ static void *ptest(void *parm)
 				/* these tests must use sgio */
 				if (i == 0 || i == 1 || i == 8)
 					strcat(cmd, " -u");
+				pboard(cmd, d);
 				sd_debug("%s\n", cmd);
 				res = system(cmd);
 				if (res == -1)
 					res = SD_ERR_SYS;
 				else
 					res = WEXITSTATUS(res);
+				presult(d, item[i], res);
 				/* convert to error codes */
 				if (res)
 					res = errors[i]; 
@@ -202,8 +295,9 @@ static void *ptest(void *parm)
 						break;
 				}
 				if (item[j]) {
-					char cmd[128];
+					char cmd[256];
 					if (part_test_device) {
+						pclaim(d, j);
 						if (p->opts)
 							sprintf(cmd, 
 							"%s -d %s -t %s %s -q 2 -s %lld -f %lld", 
@@ -225,6 +319,7 @@ static void *ptest(void *parm)
 					/* these tests must use sgio */
 					if (j == 0 || j == 1 || j == 8)
 						strcat(cmd, " -u");
+					pboard(cmd, d);
 					sd_debug("%s\n", cmd);
 					res = system(cmd);
 					sd_debug("cmd res %d(%d)\n", res, (res & 0xff00) >> 8);
@@ -232,6 +327,7 @@ static void *ptest(void *parm)
 						res = SD_ERR_SYS;
 					else
 						res = WEXITSTATUS(res);
+					presult(d, item[j], res);
 				}
 				/* convert to error codes */
 				if (res)
@@ -250,10 +346,11 @@ static void *ptest(void *parm)
 		 * for (i = 0; i < 9; i++) {
 		 */
 		for (i = 2; i < 9; i++) {
-			char cmd[128];
+			char cmd[256];
 			if (!process[0].test[i])
 				continue;
 			if (part_test_device) {
+				pclaim(d, i);
 				if (p->opts)
 					sprintf(cmd, 
 					"%s -d %s -t %s %s -q 2 -s %lld -f %lld", 
@@ -273,12 +370,14 @@ static void *ptest(void *parm)
 			/* these tests must use sgio */
 			if (i == 0 || i == 1 || i == 8)
 				strcat(cmd, " -u");
+			pboard(cmd, d);
 			sd_debug("%s\n", cmd);
 			res = system(cmd);
 			if (res == -1)
 				res = SD_ERR_SYS;
 			else
 				res = WEXITSTATUS(res);
+			presult(d, item[i], res);
 			/* convert to error codes */
 			if (res)
 				res = errors[i]; 
@@ -298,6 +397,7 @@ static void *ptest(void *parm)
 		usleep(1000);
 	}
 quit:
+	__atomic_store_n(&d->done, 1, __ATOMIC_RELEASE);
 	pthread_exit((void *)(unsigned long)res);
 }
 
@@ -361,6 +461,7 @@ static void psighandler(int sig)
 		process[i].sigs++;
 		pthread_join(process[i].thread, NULL);
 	}
+	sd_boardexit(board, bname);
 	exit(SD_ERR_USR);
 }
 
@@ -371,6 +472,7 @@ int main(int argc, char **argv)
 	const char *progname;
 	struct process_parm parm;
 	int i, ret = SD_ERR_NO;
+	int monitor = isatty(STDOUT_FILENO) ? BOARD_SECS : 0;
 	struct stat st;
 	off_t size;
 
@@ -385,7 +487,7 @@ int main(int argc, char **argv)
 	memset(&parm, 0, sizeof(struct process_parm));
 	memset(process, 0, sizeof(struct process_data) * NUM_THREADS);
 
-	while ((i = getopt(argc, argv, "d:t:r:spo:h")) != -1) {
+	while ((i = getopt(argc, argv, "d:t:r:spo:m:h")) != -1) {
 		switch (i) {
 		case 'd':
 			parm.device = optarg;
@@ -409,9 +511,16 @@ int main(int argc, char **argv)
 		case 'o':
 			parm.opts = optarg;
 			break;
+		case 'm':
+			monitor = atoi(optarg);
+			if (monitor < 0) {
+				tperr("monitor: bad value\n");
+				exit(SD_ERR_USR);
+			}
+			break;
 		case 'h':
 		default:
-			tpout("usage: %s [-d device] [-t test] [-r thread] [-s] [-p] [-o optstring]\n", progname);
+			tpout("usage: %s [-d device] [-t test] [-r thread] [-s] [-p] [-o optstring] [-m seconds]\n", progname);
 			exit(SD_ERR_NO);
 		}
 	}
@@ -455,7 +564,7 @@ int main(int argc, char **argv)
 	 * do 'interf' & 'selfd' test first before the main loop
 	 */
 	if (!strcmp(process[0].test[0], "interf")) {
-		char cmd[128];
+		char cmd[256];
 
 		sprintf(cmd, "%s -d %s -t %s -u", sdtest, parm.device, item[0]);
 		ret = system(cmd);
@@ -470,7 +579,7 @@ int main(int argc, char **argv)
 		}
 	}
 	if (!strcmp(process[0].test[1], "selfd")) {
-		char cmd[128];
+		char cmd[256];
 
 		sprintf(cmd, "%s -d %s -t %s -u", sdtest, parm.device, item[1]);
 		ret = system(cmd);
@@ -485,14 +594,28 @@ int main(int argc, char **argv)
 		}
 	}
 
+	if (monitor && parm.thread) {
+		na = (char *)strrchr(parm.device, '/');
+		na = na ? (na + 1) : parm.device;
+		snprintf(bname, sizeof(bname), "/process-%s-%d", na, getpid());
+		board = sd_boardinit(bname, parm.thread);
+		if (!board)
+			tperr("status board not available\n");
+	}
+
+	if (part_test_device && parm.thread) {
+		/* can't be larger than size of device, 1M aligned if it can */
+		slices = parm.thread * PROC_SLICES;
+		slice_dev = size;
+		slice_size = size / slices;
+		if (slice_size >= (1 << 20))
+			slice_size &= ~((off_t)(1 << 20) - 1);
+	}
+
 	for (i = 0; i < parm.thread; i++) {
 		/* init thread */
+		process[i].ind = i;
 		process[i].parm = &parm;
-		if (part_test_device) {
-			/* can't be larger than size of device */
-			process[i].size  = size / parm.thread;
-			process[i].start = 0 + (process[i].size * i);
-		}
 		pthread_attr_init(&process[i].attr);
 		
 		if (pthread_create(&process[i].thread, NULL, ptest, &process[i])) {
@@ -505,6 +628,21 @@ int main(int argc, char **argv)
 		
 	usleep(1000);
 
+	/* refresh the table until every thread is done */
+	if (board) {
+		int n, done;
+
+		for (n = 0; ; n++) {
+			prender(parm.thread, n);
+			for (done = 0, i = 0; i < parm.thread; i++)
+				done += __atomic_load_n(&process[i].done,
+						__ATOMIC_ACQUIRE);
+			if (done == parm.thread)
+				break;
+			sleep(monitor);
+		}
+	}
+
 	for (i = 0; i < parm.thread; i++) {
 		if (pthread_join(process[i].thread, (void *)&ret)) {
 			tperr("pthread join: %s\n", strerror(errno));
@@ -520,6 +658,7 @@ int main(int argc, char **argv)
 	tptout("%s: COMPLETED\n", progname);
 	
 	exit_thread(&parm);
+	sd_boardexit(board, bname);
 
 	/* put ret value in .process-sdX before exit */
 	na = (char *)strrchr(parm.device, '/');
@@ -0,0 +1,183 @@
+/* scandb.c
+ *
+ * Author: Xiang-Yu Wang <rain_wang@jabil.com>
+ *
+ * Copyright (c) 2008 Jabil, Inc.
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * 2026-10-19 made initial version, the device is split into regions and
+ *            the time and result of the last scan of every region is kept
+ *            in a file of the device serial, so a scrub spreads over runs
+ *            a header of no region size is not a scan state
+ *
+ */
+
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "sdtest.h"
+#include "utils.h"
+#include "scandb.h"
+
+/* header of the state file, followed by the records of the regions */
+struct sd_scanhdr {
+	unsigned int	magic;
+	unsigned int	n;
+	long long	size;
+	long long	region;
+	char		serial[128];
+};
+
+static void sd_scannew(struct sd_scandb *db)
+{
+	off_t mb = SCAN_MIN;
+
+	db->region = (db->size + SCAN_REGIONS - 1) / SCAN_REGIONS;
+	db->region = (db->region + mb - 1) / mb * mb;
+	if (db->region < mb)
+		db->region = mb;
+	db->n = (db->size + db->region - 1) / db->region;
+	memset(db->rec, 0, SCAN_REGIONS * sizeof(*db->rec));
+}
+
+int sd_scanopen(struct sd_scandb *db, const char *dir, const char *serial,
+		off_t size)
+{
+	struct sd_scanhdr hdr;
+	int fd;
+
+	memset(db, 0, sizeof(*db));
+	snprintf(db->serial, sizeof(db->serial), "%s", serial);
+	snprintf(db->path, sizeof(db->path), "%s/%s.scan", dir, serial);
+	db->size = size;
+
+	if (!(db->rec = calloc(SCAN_REGIONS, sizeof(*db->rec)))) {
+		tperr("scandb: %s\n", strerror(errno));
+		return SD_ERR;
+	}
+	if (mkdir(dir, 0755) < 0 && errno != EEXIST) {
+		tperr("scandb: %s: %s\n", dir, strerror(errno));
+		goto err;
+	}
+
+	sd_scannew(db);
+	if ((fd = open(db->path, O_RDONLY)) < 0) {
+		if (errno == ENOENT)
+			return SD_ERR_NO;
+		tperr("scandb: %s: %s\n", db->path, strerror(errno));
+		goto err;
+	}
+
+	if (read(fd, &hdr, sizeof(hdr)) != sizeof(hdr) ||
+			hdr.magic != SCAN_MAGIC || hdr.n > SCAN_REGIONS ||
+			hdr.region <= 0 || hdr.size <= 0 ||
+			hdr.n != (hdr.size + hdr.region - 1) / hdr.region) {
+		tperr("scandb: %s: not a scan state, started over\n", db->path);
+	} else if (hdr.size != size) {
+		tperr("scandb: %s: device size changed from %lld, started "
+			"over\n", db->path, hdr.size);
+	} else {
+		db->region = hdr.region;
+		db->n = hdr.n;
+		if (read(fd, db->rec, db->n * sizeof(*db->rec)) !=
+				(ssize_t)(db->n * sizeof(*db->rec))) {
+			tperr("scandb: %s: truncated, started over\n",
+				db->path);
+			sd_scannew(db);
+		}
+	}
+	close(fd);
+
+	return SD_ERR_NO;
+err:
+	free(db->rec);
+	db->rec = NULL;
+	return SD_ERR;
+}
+
+int sd_scansave(struct sd_scandb *db)
+{
+	char tmp[PATH_MAX + 8];
+	struct sd_scanhdr hdr;
+	size_t len = db->n * sizeof(*db->rec);
+	int fd;
+
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.magic = SCAN_MAGIC;
+	hdr.n = db->n;
+	hdr.size = db->size;
+	hdr.region = db->region;
+	snprintf(hdr.serial, sizeof(hdr.serial), "%s", db->serial);
+
+	/* a crash leaves the old state or the new one, never a mix */
+	snprintf(tmp, sizeof(tmp), "%s.tmp", db->path);
+	if ((fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0) {
+		tperr("scandb: %s: %s\n", tmp, strerror(errno));
+		return SD_ERR;
+	}
+	if (write(fd, &hdr, sizeof(hdr)) != sizeof(hdr) ||
+			write(fd, db->rec, len) != (ssize_t)len ||
+			fsync(fd) < 0) {
+		tperr("scandb: %s: %s\n", tmp, strerror(errno));
+		close(fd);
+		unlink(tmp);
+		return SD_ERR;
+	}
+	close(fd);
+	if (rename(tmp, db->path) < 0) {
+		tperr("scandb: %s: %s\n", db->path, strerror(errno));
+		unlink(tmp);
+		return SD_ERR;
+	}
+
+	return SD_ERR_NO;
+}
+
+void sd_scanclose(struct sd_scandb *db)
+{
+	free(db->rec);
+	db->rec = NULL;
+}
+
+static struct sd_scanrec *scan_rec;
+
+static int sd_scancmp(const void *a, const void *b)
+{
+	const struct sd_scanrec *x = &scan_rec[*(const int *)a];
+	const struct sd_scanrec *y = &scan_rec[*(const int *)b];
+
+	if ((x->res == SCAN_BAD) != (y->res == SCAN_BAD))
+		return x->res == SCAN_BAD ? -1 : 1;
+	if (x->time != y->time)
+		return x->time < y->time ? -1 : 1;
+	return *(const int *)a - *(const int *)b;
+}
+
+int sd_scandue(struct sd_scandb *db, unsigned long age, int *due)
+{
+	unsigned long now = time(NULL);
+	struct sd_scanrec *r;
+	int i, n = 0;
+
+	for (i = 0; i < db->n; i++) {
+		r = &db->rec[i];
+		if (r->res == SCAN_BAD || r->res == SCAN_NEVER ||
+				now - r->time >= age)
+			due[n++] = i;
+	}
+
+	scan_rec = db->rec;
+	qsort(due, n, sizeof(*due), sd_scancmp);
+
+	return n;
+}
@@ -0,0 +1,66 @@
+/* scandb.h
+ *
+ * Author: Xiang-Yu Wang <rain_wang@jabil.com>
+ *
+ * Copyright (c) 2008 Jabil, Inc.
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * 2026-10-19 made initial version
+ *
+ */
+
+#ifndef SCANDB_H
+#define SCANDB_H
+
+#include <limits.h>
+#include <sys/types.h>
+
+#include "sdtest.h"
+
+#define SCAN_MAGIC	0x73647363	/* "sdsc" */
+#define SCAN_DIR	"/var/lib/sdtest"
+#define SCAN_REGIONS	1024		/* regions of a device at most */
+#define SCAN_MIN	(1024 * 1024)	/* bytes of a region at least */
+
+/* results of a region */
+enum {
+	SCAN_NEVER,
+	SCAN_OK,
+	SCAN_BAD,
+};
+
+/* one region as saved, the time of the last scan and its result */
+struct sd_scanrec {
+	unsigned int	time;	/* seconds since the epoch, 0 for never */
+	unsigned int	res;	/* SCAN_NEVER, SCAN_OK or SCAN_BAD */
+};
+
+/* scan state of a device, "dir/serial.scan" */
+struct sd_scandb {
+	char		path[PATH_MAX];	/* state file */
+	char		serial[128];	/* key of the device */
+	off_t		size;	/* byte size of the device */
+	off_t		region;	/* byte size of every region */
+	int		n;	/* regions */
+
+	struct sd_scanrec *rec;
+};
+
+/* load or create the state of a device, -1 on error */
+extern int sd_scanopen(struct sd_scandb *, const char *, const char *, off_t);
+
+/* save the state, replacing the file as a whole */
+extern int sd_scansave(struct sd_scandb *);
+
+extern void sd_scanclose(struct sd_scandb *);
+
+/*
+ * regions due to a scan, failed ones first, then never scanned and the
+ * oldest, none scanned within age seconds, return the number of them
+ */
+extern int sd_scandue(struct sd_scandb *, unsigned long, int *);
+
+#endif /* SCANDB_H */
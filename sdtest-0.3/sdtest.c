@@ -18,6 +18,37 @@
  *            the io modules
  * 2008-03-17 fixed a bug in 'sd_getbs', 512 should be set before all 'bsget'
  * 2008-04-14 made test 'pattern' option
+ * 2026-10-19 added 'xfer' option, let io module provide the data buffer
+ *            through 'bufget' hook, e.g. the mmap-ed sg reserved buffer
+ *            added bsg device support by sg v4 interface, 'depth' option
+ *            made threaded test run, one device descriptor per thread,
+ *            'cpus' and 'numa' options, report of blk-mq queue mapping
+ *            test buffers come from the buffer pool, 'huge' option
+ *            io counted per thread through stats hooks, 'live' option
+ *            'board' option, status published to the board of process
+ *            threads claim chunks of the test space from a dispenser
+ *            instead of testing fixed pieces
+ *            regular files are tested through the file io module sized by
+ *            'fstat', 'alloc' and 'files' options, fixed a crash in
+ *            'init_test' on a device name without '/'
+ *            'sync' and 'every' options, flushes or synchronous writes
+ *            at a cadence of writes or bytes
+ *            caching mode page reported before the test, 'cache' option
+ *            to change it for the test or to run an A/B test
+ *            transfers up to MAX_BPT_SIZE instead of resetting 'blocks',
+ *            split into commands of the device limits, which are reported
+ *            physical block size and lowest aligned lba in device info
+ *            'align' option to run the test at offsets from the physical
+ *            sector, the block is the logical one by default
+ *            'time' option to repeat passes for a time instead of a count
+ *            'rate' option to pace transfers, 'slo' option to search the
+ *            highest rate of a latency target by timed probes
+ *            'zones' option to profile the test at regions spread across
+ *            the capacity, slow bands against their neighbours reported
+ *            'bseek' seek profile is not threaded, and direct io
+ *            the coverage is a stratified sample of the test space
+ *            'scandb' option to scan only the regions due by the scan
+ *            state of the device, the time is the window of the scrub
  *
  */
 
@@ -40,12 +71,21 @@
 #include <sys/mman.h>
 #include <sys/time.h>
 #include <sys/ioctl.h>
+#include <time.h>
 #include <pthread.h>
 #include <linux/major.h> 
 
 #include "sdtest.h"
 #include "algos.h"
 #include "utils.h"
+#include "cpus.h"
+#include "pool.h"
+#include "stats.h"
+#include "board.h"
+#include "sync.h"
+#include "cache.h"
+#include "pace.h"
+#include "scandb.h"
 
 #ifndef O_DIRECT
 #define O_DIRECT	00040000
@@ -68,6 +108,9 @@
 #define DEF_END		0 
 #define DEF_COVERAGE	100
 #define DEF_PATTERN	0x5a5a5a5a
+#define DEF_DEPTH	1
+#define DEF_NUMA	-1
+#define AUTO_NUMA	-2
 
 static struct test_parm test_parm = {
 	.device		= DEF_DEVICE,
@@ -85,27 +128,91 @@ static struct test_parm test_parm = {
 	.backup		= 0,
 	.sgio		= 0,
 	.direct		= 0,
+	.xfer		= SD_XFER_COPY,
+	.depth		= DEF_DEPTH,
+	.cpus		= NULL,
+	.numa		= DEF_NUMA,
+	.huge		= 0,
+	.live		= 0,
+	.board		= NULL,
+	.alloc		= 0,
+	.files		= 0,
+	.sync		= SD_SYNC_NONE,
+	.synops		= 1,
+	.synbytes	= 0,
+	.cache		= NULL,
+	.align		= NULL,
+	.time		= 0,
+	.deadline	= NULL,
+	.rate		= 0,
+	.slo		= NULL,
+	.zones		= NULL,
+	.scandb		= NULL,
 	.nopro		= 0,
 };
 
 static int getinfo = 0;
+
+/* the passes are repeated till the deadline of a timed test */
+#define TIME_PASSES	65536
+static int pass_set = 0;
+static struct timespec deadline;
+static int passes_run = 0;
+
+/* latency target of the rate search, percentile and usec */
+#define SLO_PROBE	5	/* seconds of a probe by default */
+#define SLO_STEPS	10	/* most probes of the search */
+#define SLO_CLOSE	2	/* percent apart of rates to stop at */
+#define SLO_SHORT	95	/* percent of the rate a probe must reach */
+static int slo_pct;
+static unsigned long long slo_us;
+
+/* regions of the zone profile and bytes of every one */
+#define MAX_ZONES	1024
+#define ZONE_SIZE	(64 * 1024 * 1024)
+#define ZONE_NEAR	2	/* neighbours each side of the local median */
+#define ZONE_SLOW	15	/* percent under it of a slow band */
+static int nzones = 0;
+static off_t zone_size = ZONE_SIZE;
+
+/* regions due to a scan by their state, and the window of the scrub */
+#define SCAN_AGE	(7 * 24 * 3600)
+static unsigned long scan_age = SCAN_AGE;
+static char scan_dir[PATH_MAX] = SCAN_DIR;
+static int scan_window = 0;
+
+/* caching mode page wanted for the test, or the A/B test */
+static struct sd_cache cache_want;
+static int cache_ab = 0;
+
+/* offsets from the physical sector of the alignment test */
+#define MAX_ALIGNS	16
+static off_t aligns[MAX_ALIGNS];
+static int naligns = 0;
+
+/* cpus to run on, thread n on the n-th one round robin */
+static int cpus[MAX_CPUS];
+static int ncpus = 0;
 static int not_allow_test_size_larger_than_disk_size = 0;
 
 /* map sd_part to sd_device in threaded test */
 static const int map_part = 0;
 
-/* page align */
-static const int page_align = 0;
-
 /*
  * supported disks 
  */
 extern struct sd_device gen_disk;
 extern struct sd_device sd_disk;
+extern struct sd_device bsg_disk;
+extern struct sd_device file_disk;
+
+extern int sd_fileprep(const char *, off_t);
 
 static struct sd_device *disks[] = { 
 	&gen_disk, 
 	&sd_disk, 
+	&bsg_disk, 
+	&file_disk, 
 	NULL 
 };
 
@@ -122,6 +229,31 @@ static struct test_algo *algos[] = {
 /*
  * core sdtest functions
  */
+static int sd_bsgmajor(void)
+{
+	char line[128], name[64];
+	int chr = 0, num, major = -1;
+	FILE *fp;
+
+	/* bsg has a dynamic major, see the character devices list */
+	if (!(fp = fopen("/proc/devices", "r")))
+		return -1;
+	while (fgets(line, sizeof(line), fp)) {
+		if (!strncmp(line, "Character", 9))
+			chr = 1;
+		else if (!strncmp(line, "Block", 5))
+			break;
+		else if (chr && sscanf(line, "%d %63s", &num, name) == 2
+				&& !strcmp(name, "bsg")) {
+			major = num;
+			break;
+		}
+	}
+	fclose(fp);
+
+	return major;
+}
+
 static int sd_filetype(const char *name)
 {
 	struct stat st;
@@ -134,10 +266,14 @@ static int sd_filetype(const char *name)
                		return SD_RAW;
                 else if (SCSI_GENERIC_MAJOR == major(st.st_rdev))
                 	return SD_SCSI_SG;
+		else if (sd_bsgmajor() == major(st.st_rdev))
+			return SD_SCSI_BSG;
 	} else if (S_ISBLK(st.st_mode)) {
                 if (SCSI_CDROM_MAJOR == major(st.st_rdev))
                		return SD_SCSI_CD;
                	return SD_BLOCK;
+	} else if (S_ISREG(st.st_mode)) {
+		return SD_FILE;
 	}
 
 	return SD_OTHER;
@@ -166,6 +302,8 @@ static int sd_getsize(struct sd_device *disk)
 	case SD_RAW:
 	case SD_SCSI_SG:
 	case SD_SCSI_CD:
+	case SD_SCSI_BSG:
+	case SD_FILE:
 		if (disk->blkget(disk) < 0) {
 			disk->stat = SD_ERR_SYS;
 			return SD_ERR;
@@ -189,6 +327,53 @@ static int sd_getsize(struct sd_device *disk)
 	}
 
 	disk->size = disk->blk * disk->bs;
+	/* the io module found no physical block */
+	if (!disk->pbs)
+		disk->pbs = disk->bs;
+	return SD_ERR_NO;
+}
+
+/*
+ * the largest command the device takes: the request queue limit in
+ * sysfs, the hardware one for sgio while the kernel splits block io
+ * at the soft one, and the limits the io module finds on the device
+ */
+static void sd_getcmdmax(struct sd_device *disk)
+{
+	const char *attr = "max_hw_sectors_kb";
+	long kb;
+
+	if (disk == &gen_disk)
+		attr = "max_sectors_kb";
+	disk->cmdmax = 0;
+	if (disk->type != SD_FILE
+			&& (kb = sd_queueattr(disk->parm->device, attr)) > 0)
+		disk->cmdmax = kb * 1024;
+	if (disk->maxget)
+		disk->maxget(disk);
+}
+
+/* the transfer size and the commands it is split into */
+static void sd_xferinfo(struct sd_device *disk)
+{
+	int xfer = disk->parm->block * disk->parm->blocks;
+	int cmd = xfer;
+
+	if (disk->cmdmax && disk->cmdmax < xfer)
+		cmd = disk->cmdmax / disk->bs * disk->bs;
+	tpout("Transfer: %d bytes, %d commands of %d bytes, device max %d\n",
+			xfer, (xfer + cmd - 1) / cmd, cmd, disk->cmdmax);
+}
+
+/* the caching mode page of scsi devices, quiet on others */
+static int sd_cacheinfo(struct sd_device *disk)
+{
+	struct sd_cache c;
+
+	if (sd_cacheget(disk->fd, &c) < 0)
+		return SD_ERR;
+	tpout("Cache: wce %d rcd %d dra %d prefetch %d-%d segments %d\n",
+			c.wce, c.rcd, c.dra, c.minpf, c.maxpf, c.segs);
 	return SD_ERR_NO;
 }
 
@@ -199,6 +384,12 @@ static int sd_getinfo(struct sd_device *disk)
 			disk->name, disk->bs, disk->blk);
 	/* break the info into two, for 'tpout' problem */
 	tpout("size: %lld bytes\n", disk->size);
+	tpout("Block: logical %d physical %d lowest aligned lba %lld\n",
+			disk->bs, disk->pbs, (long long)disk->align);
+	tpout("Numa node: %d\n", sd_numanode(disk->parm->device));
+	sd_prmqmap(disk->parm->device);
+	sd_cacheinfo(disk);
+	sd_xferinfo(disk);
 	return SD_ERR_NO;
 }
 
@@ -223,6 +414,14 @@ static struct sd_device *sd_get(const char *name, int sgio)
 	case SD_SCSI_SG:
 		typename = SCSI_DISK;
 		break;
+	case SD_SCSI_BSG:
+		typename = BSG_DISK;
+		break;
+	case SD_FILE:
+		typename = FILE_DISK;
+		if (sgio)
+			tperr("sgio: not for files, use the filesystem\n");
+		break;
 	case SD_OTHER:
 		typename = GENERIC_DISK;
 		break;
@@ -250,6 +449,8 @@ static void sd_set(struct sd_device *disk)
 	disk->bs	= 0;
 	disk->blk	= 0;
 	disk->size	= 0;
+	disk->pbs	= 0;
+	disk->align	= 0;
 
 	disk->fd	= -1;
 	disk->pos	= 0;
@@ -304,10 +505,17 @@ static struct sd_test *test_get(struct sd_device *disk, const char *name)
 	return test;
 }
 
+/* the deadline of a timed test passed, checked between passes */
+static int sd_timeup(struct test_parm *p)
+{
+	return sd_pastdue(p->deadline);
+}
+
 static int do_test(struct sd_device *disk, struct test_parm *p)
 {
 	struct sd_test *test;
-	int i, psz; 
+	int i;
+	size_t size = p->block * p->blocks;
 	char *wbuf = NULL;
 
 	test = test_get(disk, p->test);
@@ -316,31 +524,26 @@ static int do_test(struct sd_device *disk, struct test_parm *p)
 		return SD_ERR_SYS;
 	}
 
-        psz = getpagesize();
-        if (page_align || disk->type == SD_RAW) {
-               	wbuf = (char *)malloc(p->block * p->blocks + psz);
-               	if (!wbuf) {
-                       	tperr("not enough user memory for aligned storage\n");
-                       	return SD_ERR_SYS;
-               	}
-               	disk->buf = (char *)(((unsigned long)wbuf + psz - 1) & (~(psz - 1)));
-        } else {
-               	wbuf = (char *)malloc(p->block * p->blocks);
-               	if (!wbuf) {
-                       	tperr("not enough user memory\n");
-                       	return SD_ERR_SYS;
-               	}
-               	disk->buf = wbuf;
-        }
+	if (disk->bufget && (disk->buf = disk->bufget(disk, size))) {
+		/* buffer of io method, e.g. mmap-ed sg reserved buffer */
+		wbuf = NULL;
+	} else if (!(disk->buf = wbuf = sd_poolget()))
+		return SD_ERR_SYS;
 
 	for (i = 1; i <= p->pass; i++) {
+		if (i > 1 && sd_timeup(p))
+			break;
 		tpout("%2d:", i);
 		if ((test->stat = test->func(p, disk)) < 0)
 			break;
 		tpout("\b\b\b");
 	}
+	passes_run = i - 1;
 
-	free(disk->buf);
+	if (disk->bufput)
+		disk->bufput(disk, disk->buf, size);
+	sd_poolput(wbuf);
+	disk->buf = NULL;
 
 	return test->stat;
 }
@@ -348,8 +551,14 @@ static int do_test(struct sd_device *disk, struct test_parm *p)
 static struct sd_device *init_test(struct test_parm *p)
 {
 	struct sd_device *disk;
+	struct stat st;
 	int flags;
 
+	/* a file target is created and allocated before anything */
+	if (p->alloc && (stat(p->device, &st) < 0 || S_ISREG(st.st_mode))
+			&& sd_fileprep(p->device, p->alloc) != SD_ERR_NO)
+		return NULL;
+
 	disk = sd_get(p->device, p->sgio);
 	if (!disk) {
 		tperr("%s: Device empty or not exist\n", p->device);
@@ -359,7 +568,25 @@ static struct sd_device *init_test(struct test_parm *p)
 	sd_set(disk);
 
 	disk->name = (const char *)strrchr(p->device, '/');
-	disk->name = disk->name + 1;
+	disk->name = disk->name ? (disk->name + 1) : p->device;
+
+	/* the seek profile times one read after another */
+	if (p->thread && !strcmp(p->test, BUTT_SEEK)) {
+		tperr("%s: not threaded, use one thread\n", BUTT_SEEK);
+		p->thread = 0;
+	}
+	/* and of the device, not of the page cache and its read-ahead */
+	if (!p->direct && !strcmp(p->test, BUTT_SEEK) && disk != &sd_disk
+			&& disk != &bsg_disk) {
+		tperr("%s: not through the page cache, use direct io\n",
+				BUTT_SEEK);
+		p->direct = 1;
+	}
+
+	if (p->files && disk->type != SD_FILE) {
+		tperr("files: only for file targets, ignored\n");
+		p->files = 0;
+	}
 
 	/* 
 	 * keep a parameter structure for io modules' use 
@@ -370,6 +597,30 @@ static struct sd_device *init_test(struct test_parm *p)
 
 	test_set(disk);
 
+	if (p->cpus) {
+		ncpus = sd_cpuparse(p->cpus, cpus, MAX_CPUS);
+		if (ncpus < 0) {
+			tperr("cpus: bad cpu list %s\n", p->cpus);
+			return NULL;
+		}
+	}
+	if (p->numa == AUTO_NUMA) {
+		p->numa = sd_numanode(p->device);
+		if (p->numa < 0)
+			tperr("numa: no node of %s, use any\n", p->device);
+	}
+
+	/* transfer modes only make sense to sgio */
+	if (p->xfer != SD_XFER_COPY && disk != &sd_disk) {
+		tperr("xfer: only for sgio, use copy\n");
+		p->xfer = SD_XFER_COPY;
+	}
+	/* only one reserved buffer per sg device descriptor */
+	if (p->xfer == SD_XFER_MMAP && p->thread) {
+		tperr("xfer: mmap io can't be threaded, use dio\n");
+		p->xfer = SD_XFER_DIO;
+	}
+
         flags = O_RDWR;
 	if (strstr(disk->name, CDROM_DISK) || strstr(disk->name, DVDROM_DISK)
 			|| strstr(p->test, "read"))
@@ -377,6 +628,10 @@ static struct sd_device *init_test(struct test_parm *p)
         if (p->direct)
 		/* since Linux 2.6.10 */
               	flags |= O_DIRECT;
+	/* sgio sets the fua bit in its commands instead */
+	if ((p->sync == SD_SYNC_DSYNC || p->sync == SD_SYNC_FUA)
+			&& disk != &sd_disk && disk != &bsg_disk)
+		flags |= O_DSYNC;
 	if (p->thread)
 		/* since Linux 2.6.23 */
 		flags |= O_CLOEXEC;
@@ -397,18 +652,18 @@ static struct sd_device *init_test(struct test_parm *p)
 	}
 	sd_debug("disk size %lld\n", disk->size);
 	
-	/* use this block size */
-	if (!p->block) {
-		if (BASE_SEC_SIZE > disk->bs)
-			p->block = disk->bs;
-		else
-			p->block = BASE_SEC_SIZE;
-	} else if (p->block > MAX_BLK_SIZE)
+	/* use this block size, the logical one of 4Kn drives too */
+	if (!p->block || p->block > MAX_BLK_SIZE)
 		p->block = disk->bs;
 
-	/* use this blocks size */
-	if (p->blocks > MAX_BPT_SIZE / BASE_SEC_SIZE)
-		p->blocks = BPT_BLOCKS;
+	/* larger transfers are split into the commands the device takes */
+	if ((long long)p->block * p->blocks > MAX_BPT_SIZE) {
+		tperr("blocks: transfer over %d bytes, use %d blocks\n",
+				MAX_BPT_SIZE, MAX_BPT_SIZE / p->block);
+		p->blocks = MAX_BPT_SIZE / p->block;
+	}
+	sd_getcmdmax(disk);
+	sd_debug("command max %d\n", disk->cmdmax);
 	
 	/* check first */
 	if (p->start >= disk->size)
@@ -527,6 +782,8 @@ static struct sd_part *sd_getpart(struct sd_thread *thread, int idx)
 	sd_debug("part->size %lld part->start %lld\n", part->size, part->start);
 
 	part->sd = disk;
+	part->disp = NULL;
+	part->pass = 0;
 	
 	/* 
          * keep the test parameter structure per thread which
@@ -548,7 +805,7 @@ static void *ptest(void *parm)
 {	
 	struct sd_thread *thrd = parm;
 	struct sd_test *test;
-	int i, psz; 
+	int i; 
 	char *wbuf = NULL;
 
 	thrd->pid = getpid();
@@ -556,36 +813,38 @@ static void *ptest(void *parm)
 	test = test_get(thrd->dev, thrd->parm.test);
 	if (!test) {
 		tperr("%s: Test empty or not supported\n", thrd->parm.test);
+		thrd->res = SD_ERR_SYS;
 		return (void *)SD_ERR_SYS;
 	}
 
-        psz = getpagesize();
-        if (page_align || thrd->dev->type == SD_RAW) {
-               	wbuf = (char *)malloc(thrd->parm.block * thrd->parm.blocks + psz);
-               	if (!wbuf) {
-                       	tperr("not enough user memory for aligned storage\n");
-                       	return (void *)SD_ERR_SYS;
-               	}
-               	thrd->part->buf = (char *)(((unsigned long)wbuf + psz - 1) & (~(psz - 1)));
-        } else {
-               	wbuf = (char *)malloc(thrd->parm.block * thrd->parm.blocks);
-               	if (!wbuf) {
-                       	tperr("not enough user memory\n");
-                       	return (void *)SD_ERR_SYS;
-               	}
-               	thrd->part->buf = wbuf;
-        }
+	if (ncpus)
+		sd_cpubind(cpus[thrd->ind % ncpus]);
+	sd_statbind(thrd->ind);
+
+	if (!(thrd->part->buf = wbuf = sd_poolget())) {
+		thrd->res = SD_ERR_SYS;
+		return (void *)SD_ERR_SYS;
+	}
 
 	//pthread_mutex_lock(thrd->lock);
 	for (i = 1; i <= thrd->parm.pass; i++) {
+		if (i > 1 && sd_timeup(&thrd->parm))
+			break;
 		tpout("%2d:", i);
+		thrd->part->pass = i - 1;
 		if ((test->stat = test->func(thrd->part->parm, thrd->part)) < 0)
 			break;
 		tpout("\b\b\b");
 	}
 	//pthread_mutex_unlock(thrd->lock);
 
-	free(thrd->part->buf);
+	/* the most passes of a thread count */
+	pthread_mutex_lock(thrd->lock);
+	if (i - 1 > passes_run)
+		passes_run = i - 1;
+	pthread_mutex_unlock(thrd->lock);
+
+	sd_poolput(wbuf);
 	thrd->part->buf = NULL;
 
 	thrd->res = test->stat;
@@ -620,6 +879,9 @@ static int init_thread(struct sd_part *part, struct sd_thread *thread)
          * each will have the equal size on which test will be
          * performed (drop the remainder or not?)
          */
+	if (thread->parm.files)
+		/* every thread has the whole test space of its own file */
+		return SD_ERR_NO;
 	thread->parm.size  = thread->parm.size / thread->parm.thread;
 	thread->parm.start = thread->parm.start + (thread->parm.size * thread->ind);
 	thread->parm.end   = thread->parm.start + thread->parm.size; /*ignored*/
@@ -642,6 +904,600 @@ static void exit_thread(struct sd_thread *thread)
 	}
 }
 
+static void put_thread(struct sd_thread *thread)
+{
+	exit_thread(thread);
+	if (thread->part)
+		sd_putpart(thread->part);
+	if (thread->dev) {
+		if (thread->dev->fd >= 0)
+			close(thread->dev->fd);
+		free(thread->dev);
+	}
+}
+
+/*
+ * threaded test, every thread claims chunks of the test space from the
+ * dispenser (butterfly tests keep a fixed piece) and tests them through
+ * a private copy of the device with its own descriptor
+ */
+static int do_ptest(struct sd_device *disk, struct test_parm *p)
+{
+	struct sd_thread *thrd, *t;
+	struct sd_disp disp;
+	pthread_mutex_t lock;
+	pthread_attr_t attr;
+	int i, n, flags, ret = SD_ERR_NO;
+
+	thrd = (struct sd_thread *)calloc(p->thread, sizeof(struct sd_thread));
+	if (!thrd) {
+		tperr("not enough user memory\n");
+		return SD_ERR_SYS;
+	}
+	if (sd_dispinit(&disp, p->start, p->size, p->block * p->blocks,
+				p->cover, p->pass, p->thread) < 0) {
+		tperr("not enough user memory\n");
+		free(thrd);
+		return SD_ERR_SYS;
+	}
+	disp.deadline = p->deadline;
+	pthread_mutex_init(&lock, NULL);
+	pthread_attr_init(&attr);
+	flags = fcntl(disk->fd, F_GETFL) & (O_ACCMODE | O_DIRECT | O_DSYNC);
+
+	for (n = 0; n < p->thread; n++) {
+		t = &thrd[n];
+		t->ind  = n;
+		t->attr = &attr;
+		t->lock = &lock;
+		t->test = p->test;
+		t->res  = SD_ERR_NO;
+		memcpy(&t->parm, p, sizeof(struct test_parm));
+
+		t->dev = (struct sd_device *)malloc(sizeof(struct sd_device));
+		if (!t->dev) {
+			tperr("not enough user memory\n");
+			break;
+		}
+		memcpy(t->dev, disk, sizeof(struct sd_device));
+		t->dev->parm = &t->parm;
+		/* the other threads test a file of the same size each */
+		if (p->files && n) {
+			snprintf(t->file, sizeof(t->file), "%s.%d", p->device, n);
+			t->parm.device = t->file;
+			if (sd_fileprep(t->file, disk->size) != SD_ERR_NO) {
+				t->dev->fd = -1;
+				put_thread(t);
+				break;
+			}
+		}
+		if ((t->dev->fd = open(t->parm.device, flags | O_CLOEXEC)) < 0) {
+			tperr("%s: open failed\n", t->parm.device);
+			put_thread(t);
+			break;
+		}
+		if (!(t->part = sd_getpart(t, n))) {
+			tperr("not enough user memory\n");
+			put_thread(t);
+			break;
+		}
+		sd_setpart(t->part);
+		t->part->disp = p->files ? NULL : &disp;
+		if (init_thread(t->part, t) != SD_ERR_NO
+				|| pthread_create(&t->self, t->attr, ptest, t)) {
+			tperr("thread %d: can't start\n", n);
+			put_thread(t);
+			break;
+		}
+	}
+
+	for (i = 0; i < n; i++) {
+		t = &thrd[i];
+		pthread_join(t->self, NULL);
+		/* the algorithms report data errors in device status only */
+		if (t->res < 0 || t->dev->stat != SD_ERR_NO) {
+			if (disk->stat == SD_ERR_NO)
+				disk->stat = t->dev->stat;
+			ret = SD_ERR;
+		}
+		put_thread(t);
+	}
+	if (n < p->thread)
+		ret = SD_ERR;
+
+	pthread_attr_destroy(&attr);
+	pthread_mutex_destroy(&lock);
+	sd_dispexit(&disp);
+	free(thrd);
+
+	return ret;
+}
+
+static int do_run(struct sd_device *disk, struct test_parm *p)
+{
+	p->deadline = NULL;
+	if (p->time) {
+		clock_gettime(CLOCK_MONOTONIC, &deadline);
+		deadline.tv_sec += p->time;
+		/* the algorithms end a pass at it too */
+		p->deadline = &deadline;
+	}
+	passes_run = 0;
+	return p->thread ? do_ptest(disk, p) : do_test(disk, p);
+}
+
+/*
+ * A/B test: the same test with the write cache on and then off, the
+ * throughput and latency of both and the delta are reported
+ */
+static int do_abtest(struct sd_device *disk, struct test_parm *p)
+{
+	struct sd_cache want;
+	struct sd_stat s0, s1, d[2];
+	struct timespec t0, t1;
+	double mbps[2];
+	int i, ret;
+
+	memset(&want, 0xff, sizeof(want));
+	for (i = 0; i < 2; i++) {
+		want.wce = !i;
+		if (sd_cacheset(disk->fd, &want) < 0)
+			return SD_ERR;
+		tpout(" wce=%d:", want.wce);
+
+		sd_statsnap(&s0);
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+		if ((ret = do_run(disk, p)) != SD_ERR_NO)
+			return ret;
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		sd_statsnap(&s1);
+
+		sd_statdiff(&d[i], &s1, &s0);
+		mbps[i] = (d[i].bytes_rd + d[i].bytes_wr) / 1e6
+			/ ((t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9);
+	}
+
+	tpterr("cache a/b: wce=1 %.2f MB/s p50 %lluus p99 %lluus, "
+			"wce=0 %.2f MB/s p50 %lluus p99 %lluus, delta %+.1f%%\n",
+			mbps[0], sd_statlat(&d[0], 50), sd_statlat(&d[0], 99),
+			mbps[1], sd_statlat(&d[1], 50), sd_statlat(&d[1], 99),
+			mbps[0] > 0 ? (mbps[1] - mbps[0]) * 100 / mbps[0] : 0.0);
+
+	return SD_ERR_NO;
+}
+
+/*
+ * offsets of the alignment test from a comma list, every one in bytes
+ * from the physical sector and a multiple of the logical block, sweep
+ * for every logical block of the physical sector (of 4K at least)
+ */
+static int sd_alignparse(const char *str, struct sd_device *disk)
+{
+	char buf[256], *tok, *save;
+	off_t off, span;
+
+	naligns = 0;
+	if (!strcmp(str, "sweep")) {
+		span = disk->pbs > 4096 ? disk->pbs : 4096;
+		for (off = 0; off < span && naligns < MAX_ALIGNS; off += disk->bs)
+			aligns[naligns++] = off;
+		return SD_ERR_NO;
+	}
+
+	snprintf(buf, sizeof(buf), "%s", str);
+	for (tok = strtok_r(buf, ",", &save); tok;
+			tok = strtok_r(NULL, ",", &save)) {
+		off = (off_t)sd_bytebox(tok, disk->bs);
+		if (off < 0 || off % disk->bs || naligns == MAX_ALIGNS) {
+			tperr("align: bad offset %s, a multiple of %d bytes\n",
+					tok, disk->bs);
+			return SD_ERR;
+		}
+		aligns[naligns++] = off;
+	}
+
+	return naligns ? SD_ERR_NO : SD_ERR;
+}
+
+/*
+ * alignment test: the same test from the physical sector and at the
+ * offsets from it, the throughput and latency at every offset and the
+ * penalty against the aligned one are reported, the misaligned writes
+ * of a 512e drive cost it a read-modify-write of the physical sectors
+ */
+static int do_aligntest(struct sd_device *disk, struct test_parm *p)
+{
+	struct sd_stat s0, s1, d[MAX_ALIGNS];
+	struct timespec t0, t1;
+	off_t start = p->start, base, room;
+	off_t xfer = p->block * p->blocks;
+	double mbps[MAX_ALIGNS], ref = 0;
+	int i, n, ret = SD_ERR_NO;
+
+	/* the first physical sector of the test space, past the lowest lba */
+	base = p->start / disk->pbs * disk->pbs
+		+ disk->align * disk->bs % disk->pbs;
+	if (base < p->start)
+		base += disk->pbs;
+
+	/* every offset tests the same space size */
+	for (i = 0, room = 0; i < naligns; i++)
+		if (aligns[i] > room)
+			room = aligns[i];
+	room = disk->size - base - room - xfer;
+	if (p->size > room)
+		p->size = room / xfer * xfer;
+	if (p->size <= 0) {
+		tperr("align: no room for the offsets\n");
+		return SD_ERR_SYS;
+	}
+
+	for (n = 0; n < naligns; n++) {
+		p->start = base + aligns[n];
+		tpout(" +%lld:", (long long)aligns[n]);
+
+		sd_statsnap(&s0);
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+		if ((ret = do_run(disk, p)) != SD_ERR_NO)
+			break;
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		sd_statsnap(&s1);
+
+		sd_statdiff(&d[n], &s1, &s0);
+		mbps[n] = (d[n].bytes_rd + d[n].bytes_wr) / 1e6
+			/ ((t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9);
+	}
+	p->start = start;
+
+	/* the penalty is against the first aligned offset */
+	for (i = 0; i < n; i++)
+		if (aligns[i] % disk->pbs == 0) {
+			ref = mbps[i];
+			break;
+		}
+	for (i = 0; i < n; i++)
+		tpterr("align +%lld: %.2f MB/s p50 %lluus p99 %lluus, "
+				"penalty %+.1f%%\n", (long long)aligns[i], mbps[i],
+				sd_statlat(&d[i], 50), sd_statlat(&d[i], 99),
+				ref > 0 ? (mbps[i] - ref) * 100 / ref : 0.0);
+
+	return ret;
+}
+
+/* latency target "pNN:time", e.g. p99:5ms p90:800us */
+static int sd_sloparse(const char *str)
+{
+	unsigned long long t;
+	char unit[8] = "";
+	int res;
+
+	if (*str == 'p' || *str == 'P')
+		str++;
+	res = sscanf(str, "%d:%llu%7s", &slo_pct, &t, unit);
+	if (res < 2 || slo_pct <= 0 || slo_pct > 100 || !t)
+		return SD_ERR;
+	if (!*unit || !strcmp(unit, "us"))
+		slo_us = t;
+	else if (!strcmp(unit, "ms"))
+		slo_us = t * 1000;
+	else if (!strcmp(unit, "s"))
+		slo_us = t * 1000000;
+	else
+		return SD_ERR;
+
+	return SD_ERR_NO;
+}
+
+/* one timed run paced at rate, 0 for none, and its transfers per second */
+static int sd_sloprobe(struct sd_device *disk, struct test_parm *p,
+		unsigned long long rate, struct sd_stat *d, double *iops)
+{
+	struct sd_stat s0, s1;
+	struct timespec t0, t1;
+	int ret;
+
+	sd_pacerate(rate);
+	sd_statsnap(&s0);
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	ret = do_run(disk, p);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	sd_statsnap(&s1);
+
+	sd_statdiff(d, &s1, &s0);
+	*iops = (d->ops_rd + d->ops_wr)
+		/ ((t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9);
+	return ret;
+}
+
+/*
+ * the highest rate meeting the latency target: a probe at the full
+ * rate (or -R), then a binary search of paced probes under it; a probe
+ * meets the target when its percentile latency is within it and it
+ * reaches the rate, a device behind the schedule missed it
+ */
+static int do_slotest(struct sd_device *disk, struct test_parm *p)
+{
+	struct sd_stat d, best;
+	unsigned long long lo = 0, hi, rate, lat;
+	double iops, found = 0;
+	int i, met, ret;
+
+	for (i = 0, rate = p->rate; i < SLO_STEPS; i++) {
+		tpout(" %llu:", rate);
+		if ((ret = sd_sloprobe(disk, p, rate, &d, &iops)) != SD_ERR_NO)
+			return ret;
+		lat = sd_statlat(&d, slo_pct);
+		met = lat <= slo_us && iops * 100 >= rate * SLO_SHORT;
+		tpterr("slo probe %llu iops: %.0f iops p%d %lluus, %s\n",
+				rate, iops, slo_pct, lat, met ? "met" : "missed");
+		if (met) {
+			found = iops;
+			best = d;
+			lo = rate;
+		} else
+			hi = rate;
+		/* the full rate sets the ceiling of the search */
+		if (i == 0) {
+			if (met)
+				break;
+			hi = rate ? rate : iops;
+		}
+		if (hi <= lo || (hi - lo) * 100 <= hi * SLO_CLOSE)
+			break;
+		rate = (lo + hi) / 2;
+		if (!rate)
+			break;
+	}
+	sd_pacerate(p->rate);
+
+	if (!found) {
+		tpterr("slo: p%d %lluus not met down to %llu iops\n",
+				slo_pct, slo_us, rate);
+		return SD_ERR_NO;
+	}
+	tpterr("slo: %.0f iops with p%d under %lluus, lat p50 %lluus "
+			"p90 %lluus p99 %lluus max %lluus\n", found, slo_pct,
+			slo_us, sd_statlat(&best, 50), sd_statlat(&best, 90),
+			sd_statlat(&best, 99), sd_statlat(&best, 100));
+	return SD_ERR_NO;
+}
+
+static int sd_dblcmp(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+
+	return (x > y) - (x < y);
+}
+
+/* median of n values, the values are kept */
+static double sd_median(const double *v, int n)
+{
+	double t[2 * ZONE_NEAR + 1];
+	double *w = t;
+	double m;
+
+	if (n > 2 * ZONE_NEAR + 1 && !(w = malloc(n * sizeof(double))))
+		return 0;
+	memcpy(w, v, n * sizeof(double));
+	qsort(w, n, sizeof(double), sd_dblcmp);
+	m = (n % 2) ? w[n / 2] : (w[n / 2 - 1] + w[n / 2]) / 2;
+	if (w != t)
+		free(w);
+	return m;
+}
+
+/* start of region i of n over the span, on a physical sector */
+static off_t sd_zonestart(struct sd_device *disk, off_t span, int i)
+{
+	off_t start = nzones > 1 ? span / (nzones - 1) * i : 0;
+
+	return start / disk->pbs * disk->pbs;
+}
+
+/*
+ * zone profile: the test on regions evenly spread over the whole
+ * capacity, the throughput and latency of every region by its lba are
+ * the curve; a region slower than the median of its neighbours is a
+ * slow band, as the zones of a disk only change slowly across it
+ */
+static int do_zonetest(struct sd_device *disk, struct test_parm *p)
+{
+	struct sd_stat s0, s1, d;
+	struct timespec t0, t1;
+	off_t start = p->start, size = p->size, span;
+	double *mbps, local, med;
+	int i, lo, hi, slow = 0, ret = SD_ERR_NO;
+
+	if (!(mbps = calloc(nzones, sizeof(double)))) {
+		tperr("not enough user memory\n");
+		return SD_ERR_SYS;
+	}
+	if (zone_size > disk->size / nzones)
+		zone_size = disk->size / nzones;
+	zone_size = zone_size / (p->block * p->blocks) * (p->block * p->blocks);
+	if (zone_size <= 0) {
+		tperr("zones: regions smaller than a transfer\n");
+		free(mbps);
+		return SD_ERR_SYS;
+	}
+	span = disk->size - zone_size;
+
+	for (i = 0; i < nzones; i++) {
+		p->start = sd_zonestart(disk, span, i);
+		p->size = zone_size;
+		tpout(" %d:", i);
+
+		sd_statsnap(&s0);
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+		if ((ret = do_run(disk, p)) != SD_ERR_NO)
+			break;
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		sd_statsnap(&s1);
+
+		sd_statdiff(&d, &s1, &s0);
+		mbps[i] = (d.bytes_rd + d.bytes_wr) / 1e6
+			/ ((t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9);
+		tpterr("zone %d lba %lld: %.2f MB/s p50 %lluus p99 %lluus\n", i,
+				(long long)(p->start / disk->bs), mbps[i],
+				sd_statlat(&d, 50), sd_statlat(&d, 99));
+	}
+	p->start = start;
+	p->size = size;
+	if (ret != SD_ERR_NO) {
+		free(mbps);
+		return ret;
+	}
+
+	for (i = 0; i < nzones; i++) {
+		lo = i - ZONE_NEAR < 0 ? 0 : i - ZONE_NEAR;
+		hi = i + ZONE_NEAR >= nzones ? nzones - 1 : i + ZONE_NEAR;
+		local = sd_median(mbps + lo, hi - lo + 1);
+		if (mbps[i] * 100 < local * (100 - ZONE_SLOW)) {
+			tpterr("zone %d lba %lld: slow band, %.2f MB/s against "
+					"%.2f MB/s near it\n", i, (long long)
+					(sd_zonestart(disk, span, i) / disk->bs),
+					mbps[i], local);
+			slow++;
+		}
+	}
+	med = sd_median(mbps, nzones);
+	qsort(mbps, nzones, sizeof(double), sd_dblcmp);
+	tpterr("zones: %d of %lld bytes, min %.2f median %.2f max %.2f MB/s, "
+			"%d slow\n", nzones, (long long)zone_size, mbps[0], med,
+			mbps[nzones - 1], slow);
+	free(mbps);
+
+	return SD_ERR_NO;
+}
+
+/* age of regions to rescan, "age[:dir]", e.g. 7d 12h:/var/lib/sdtest */
+static int sd_scanparse(const char *arg)
+{
+	unsigned long n;
+	char *end;
+
+	n = strtoul(arg, &end, 10);
+	if (end == arg)
+		return SD_ERR;
+	switch (*end) {
+	case 's':
+		end++;
+		break;
+	case 'm':
+		n *= 60;
+		end++;
+		break;
+	case 'h':
+		n *= 3600;
+		end++;
+		break;
+	case 'd':
+		end++;
+		/* fall through */
+	default:
+		n *= 24 * 3600;
+		break;
+	}
+	if (*end == ':' && end[1])
+		snprintf(scan_dir, sizeof(scan_dir), "%s", end + 1);
+	else if (*end)
+		return SD_ERR;
+	scan_age = n;
+
+	return SD_ERR_NO;
+}
+
+/*
+ * incremental scrub: the test on every region of the device due by its
+ * scan state, failed regions first and then the least recently scanned,
+ * the time and result of every region saved as soon as it is done, so a
+ * scrub stopped by its window goes on where it stopped the next time
+ */
+static int do_scantest(struct sd_device *disk, struct test_parm *p)
+{
+	struct sd_scandb db;
+	struct timespec end, now;
+	char serial[128];
+	off_t start = p->start, size = p->size;
+	int *due, ndue, i, r, res, done = 0, bad = 0, ret = SD_ERR_NO;
+	const char *c;
+
+	/* not all devices have a serial, the name and size go instead */
+	if (sd_serial(disk->name, serial, sizeof(serial)) < 0) {
+		for (c = disk->name, i = 0; *c && i < 100; c++)
+			if (isalnum(*c) || *c == '-' || *c == '.')
+				serial[i++] = *c;
+			else if (i)
+				serial[i++] = '_';
+		snprintf(serial + i, sizeof(serial) - i, "-%lld",
+				(long long)disk->size);
+	}
+	if (sd_scanopen(&db, scan_dir, serial, disk->size) < 0)
+		return SD_ERR_SYS;
+	if (!(due = calloc(db.n, sizeof(int)))) {
+		tperr("not enough user memory\n");
+		sd_scanclose(&db);
+		return SD_ERR_SYS;
+	}
+	ndue = sd_scandue(&db, scan_age, due);
+	if (db.region < p->block * p->blocks) {
+		tperr("scandb: regions smaller than a transfer\n");
+		ndue = 0;
+		ret = SD_ERR_SYS;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	end.tv_sec += scan_window;
+	for (i = 0; i < ndue; i++) {
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		if (scan_window && now.tv_sec >= end.tv_sec)
+			break;
+
+		r = due[i];
+		p->start = r * db.region;
+		p->size = db.region < disk->size - p->start ? db.region
+			: disk->size - p->start;
+		p->size = p->size / (p->block * p->blocks)
+			* (p->block * p->blocks);
+		tpout(" %d:", r);
+
+		disk->stat = SD_ERR_NO;
+		res = do_run(disk, p);
+		/* a bad option fails every region alike */
+		if (res != SD_ERR_NO && disk->stat == SD_ERR_USR) {
+			ret = res;
+			break;
+		}
+		db.rec[r].time = time(NULL);
+		db.rec[r].res = res == SD_ERR_NO ? SCAN_OK : SCAN_BAD;
+		if (res != SD_ERR_NO) {
+			tpterr("scan region %d lba %lld: failed\n", r,
+					(long long)(p->start / disk->bs));
+			bad++;
+		}
+		done++;
+		if (sd_scansave(&db) < 0) {
+			ret = SD_ERR_SYS;
+			break;
+		}
+	}
+	p->start = start;
+	p->size = size;
+
+	tpterr("scan: %d of %d regions of %lld bytes due, %d scanned, "
+			"%d failed, %d left, %s\n", ndue, db.n,
+			(long long)db.region, done, bad, ndue - done, db.path);
+	free(due);
+	sd_scanclose(&db);
+
+	if (ret == SD_ERR_NO && bad) {
+		if (disk->stat == SD_ERR_NO)
+			disk->stat = SD_ERR_TEST;
+		ret = SD_ERR;
+	}
+	return ret;
+}
+
 static void sd_sighandler(int sig)
 {
 	tperr("test interrupted (%s)\n", strsignal(sig));
@@ -666,6 +1522,24 @@ static int parse(const char *name, int *argc, char ***argv, struct test_parm *p)
 		{ "backup",	0, 0, 'k' },
 		{ "sgio",	0, 0, 'u' },
 		{ "direct",	0, 0, 'n' },
+		{ "xfer",	1, 0, 'x' },
+		{ "depth",	1, 0, 'e' },
+		{ "cpus",	1, 0, 'P' },
+		{ "numa",	1, 0, 'N' },
+		{ "huge",	0, 0, 'H' },
+		{ "live",	1, 0, 'l' },
+		{ "board",	1, 0, 'B' },
+		{ "alloc",	1, 0, 'A' },
+		{ "files",	0, 0, 'F' },
+		{ "sync",	1, 0, 'S' },
+		{ "every",	1, 0, 'Y' },
+		{ "cache",	1, 0, 'C' },
+		{ "align",	1, 0, 'L' },
+		{ "time",	1, 0, 'T' },
+		{ "rate",	1, 0, 'R' },
+		{ "slo",	1, 0, 'M' },
+		{ "zones",	1, 0, 'Z' },
+		{ "scandb",	1, 0, 'D' },
 		{ "quiet",	1, 0, 'q' },
 		{ "info",	0, 0, 'i' },
 		{ "version",	0, 0, 'v' },
@@ -687,6 +1561,24 @@ static int parse(const char *name, int *argc, char ***argv, struct test_parm *p)
 		"(K)eep in backup test mode for preserving data.",
 		"(U)se sgio interface to access device.",
 		"(N)on asynchronous direct I/O method.",
+		"(X)fer mode of sgio data, e.g. copy mmap dio.",
+		"D(e)pth of outstanding commands on bsg, e.g. 1 8 32.",
+		"C(P)u list to run test threads on, e.g. 0-3,8.",
+		"(N)UMA node of data buffers, e.g. auto 0 1.",
+		"(H)uge pages backing data buffers.",
+		"(L)ive stats of all threads every n seconds.",
+		"(B)oard slot of process to publish status to, e.g. /name:0.",
+		"(A)llocate the file to size before test, created if missing.",
+		"(F)ile of its own per thread, file.n for thread n.",
+		"(S)ync barrier of writes, e.g. fsync fdatasync dsync fua.",
+		"Ever(y) n writes or bytes written a flush, e.g. 1 16 4m.",
+		"(C)aching mode page for the test, e.g. wce=0,dra=1 or ab.",
+		"A(L)ignment test at offsets from physical sector, e.g. sweep 0,512.",
+		"(T)ime in seconds to repeat passes for, up to -p passes if given.",
+		"(R)ate of transfers per second of all threads, e.g. 5000.",
+		"(M)ax rate with latency under target, e.g. p99:5ms p90:800us.",
+		"(Z)one profile of n regions across the disk, e.g. 100 100:64m.",
+		"Scan (D)atabase, scan regions older than age, e.g. 7d 12h:/dir.",
 		"(Q)uiet run without percentage or stats.",
 		"(I)nformation of the device.",
 		"(V)ersion information.",
@@ -698,7 +1590,7 @@ static int parse(const char *name, int *argc, char ***argv, struct test_parm *p)
 
 	for (;;) {
 		int i;
-		i = getopt_long(*argc, *argv, "d:t:p:r:b:g:s:f:o:c:w:kunq:ivh", opts, NULL);
+		i = getopt_long(*argc, *argv, "d:t:p:r:b:g:s:f:o:c:w:kunx:e:P:N:Hl:B:A:FS:Y:C:L:T:R:M:Z:D:q:ivh", opts, NULL);
 		if (i == -1) {
 			break;
 		}
@@ -710,6 +1602,7 @@ static int parse(const char *name, int *argc, char ***argv, struct test_parm *p)
 			p->test = optarg;
 			break;
 		case 'p':
+			pass_set = 1;
 			p->pass = atoi(optarg);
 			if (p->pass < 0) {
 				tperr("pass: bad value\n");
@@ -868,6 +1761,150 @@ static int parse(const char *name, int *argc, char ***argv, struct test_parm *p)
 		case 'n':
 			p->direct = 1;
 			break;
+		case 'x':
+			if (!strcmp(optarg, "copy"))
+				p->xfer = SD_XFER_COPY;
+			else if (!strcmp(optarg, "mmap"))
+				p->xfer = SD_XFER_MMAP;
+			else if (!strcmp(optarg, "dio"))
+				p->xfer = SD_XFER_DIO;
+			else {
+				tperr("xfer: bad value\n");
+				exit(SD_ERR_USR);
+			}
+			break;
+		case 'e':
+			p->depth = atoi(optarg);
+			if (p->depth < 1 || p->depth > MAX_QDEPTH) {
+				tperr("depth: bad value\n");
+				exit(SD_ERR_USR);
+			}
+			break;
+		case 'P':
+			p->cpus = optarg;
+			break;
+		case 'N':
+			if (!strcmp(optarg, "auto"))
+				p->numa = AUTO_NUMA;
+			else {
+				p->numa = atoi(optarg);
+				if (p->numa < 0 || !isdigit(*optarg)) {
+					tperr("numa: bad value\n");
+					exit(SD_ERR_USR);
+				}
+			}
+			break;
+		case 'H':
+			p->huge = 1;
+			break;
+		case 'l':
+			p->live = atoi(optarg);
+			if (p->live <= 0) {
+				tperr("live: bad value\n");
+				exit(SD_ERR_USR);
+			}
+			break;
+		case 'B':
+			p->board = optarg;
+			break;
+		case 'A':
+			p->alloc = (off_t)sd_bytebox(optarg, BASE_SEC_SIZE);
+			sd_debug("alloc %lld\n", p->alloc);
+
+			if (p->alloc <= 0) {
+				tperr("alloc: bad value\n");
+				exit(SD_ERR_USR);
+			}
+			break;
+		case 'F':
+			p->files = 1;
+			break;
+		case 'S':
+			if (!strcmp(optarg, "fsync"))
+				p->sync = SD_SYNC_FSYNC;
+			else if (!strcmp(optarg, "fdatasync"))
+				p->sync = SD_SYNC_FDATA;
+			else if (!strcmp(optarg, "dsync"))
+				p->sync = SD_SYNC_DSYNC;
+			else if (!strcmp(optarg, "fua"))
+				p->sync = SD_SYNC_FUA;
+			else {
+				tperr("sync: bad value\n");
+				exit(SD_ERR_USR);
+			}
+			break;
+		case 'Y':
+			/* a plain number counts writes, with a unit bytes */
+			if (isdigit(optarg[strlen(optarg) - 1])) {
+				p->synops = atoi(optarg);
+				p->synbytes = 0;
+				if (p->synops <= 0) {
+					tperr("every: bad value\n");
+					exit(SD_ERR_USR);
+				}
+			} else {
+				p->synbytes = (off_t)sd_bytebox(optarg, 
+						BASE_SEC_SIZE);
+				if (p->synbytes <= 0) {
+					tperr("every: bad value\n");
+					exit(SD_ERR_USR);
+				}
+			}
+			sd_debug("every %d writes %lld bytes\n", 
+					p->synops, p->synbytes);
+			break;
+		case 'C':
+			p->cache = optarg;
+			if (sd_cacheparse(optarg, &cache_want, &cache_ab) < 0) {
+				tperr("cache: bad value\n");
+				exit(SD_ERR_USR);
+			}
+			break;
+		case 'L':
+			p->align = optarg;
+			break;
+		case 'R':
+			if (atoi(optarg) <= 0) {
+				tperr("rate: bad value\n");
+				exit(SD_ERR_USR);
+			}
+			p->rate = atoi(optarg);
+			break;
+		case 'M':
+			p->slo = optarg;
+			if (sd_sloparse(optarg) < 0) {
+				tperr("slo: bad value\n");
+				exit(SD_ERR_USR);
+			}
+			break;
+		case 'Z':
+		{
+			char sz[32] = "";
+
+			p->zones = optarg;
+			if (sscanf(optarg, "%d:%31s", &nzones, sz) < 1
+					|| nzones < 1 || nzones > MAX_ZONES
+					|| (*sz && (long long)(zone_size = (off_t)
+					sd_bytebox(sz, BASE_SEC_SIZE)) <= 0)) {
+				tperr("zones: bad value\n");
+				exit(SD_ERR_USR);
+			}
+			break;
+		}
+		case 'D':
+			p->scandb = optarg;
+			if (sd_scanparse(optarg) < 0) {
+				tperr("scandb: bad value\n");
+				exit(SD_ERR_USR);
+			}
+			break;
+		case 'T':
+			p->time = atoi(optarg);
+			if (p->time <= 0) {
+				tperr("time: bad value\n");
+				exit(SD_ERR_USR);
+			}
+			break;
 		case 'q':
 			p->nopro = atoi(optarg);
 			if (p->nopro < 0 || p->nopro > 2) {
@@ -910,20 +1947,49 @@ static int parse(const char *name, int *argc, char ***argv, struct test_parm *p)
 	return 0;
 }
 
+/* bytes to transfer in all passes, as counted by the io hooks */
+static unsigned long long sd_expect(struct test_parm *p)
+{
+	unsigned long long xfer = p->block * p->blocks;
+	unsigned long long n;
+	int rw = 1;
+
+	n = p->size / xfer * p->cover / 100;
+	n = (n ? n : 1) * xfer * p->pass;
+	if (strstr(p->test, "wrc"))
+		rw = p->backup ? 4 : 2;
+	else if (strstr(p->test, "write"))
+		rw = p->backup ? 3 : 1;
+	if (p->files && p->thread)
+		n *= p->thread;
+	if (cache_ab)
+		n *= 2;
+
+	return n * rw;
+}
+
 int main(int argc, char **argv)
 {
 	const char *progname;
 	struct test_parm *parm = &test_parm;
 	struct sd_device *disk;
-	struct sd_thread *thrd;
-	pthread_mutex_t lock;
-	pthread_attr_t attr;
-	int i, ret = SD_ERR_NO;
+	int ret = SD_ERR_NO;
 
 	progname = (const char *)strrchr(argv[0], '/');
 	progname = progname ? (progname + 1) : argv[0];
 
 	parse(progname, &argc, &argv, parm);
+	/* the probes of the rate search are timed */
+	if (parm->slo && !parm->time)
+		parm->time = SLO_PROBE;
+	/* the time of a scrub is its window, every region one pass */
+	if (parm->scandb) {
+		scan_window = parm->time;
+		parm->time = 0;
+	}
+	/* a timed test repeats passes till the time is up */
+	if (parm->time && !pass_set)
+		parm->pass = TIME_PASSES;
 	
 	if (geteuid() != 0) {
 		tperr("%s: must be run as root\n", progname);
@@ -945,19 +2011,87 @@ int main(int argc, char **argv)
 		exit(SD_ERR_NO);
 	}
 
+	if ((parm->slo != NULL) + (parm->zones != NULL) + (parm->align != NULL)
+			+ (parm->scandb != NULL) + cache_ab > 1) {
+		tperr("only one of the cache a/b, alignment, slo, zone and scan "
+				"tests\n");
+		tperr("init test failed\n");
+		exit(SD_ERR_USR);
+	}
+	if (parm->align && sd_alignparse(parm->align, disk) < 0) {
+		tperr("init test failed\n");
+		exit(SD_ERR_USR);
+	}
+
+	if (ncpus || parm->numa >= 0) {
+		tpout("Numa node: %d\n", parm->numa);
+		sd_prmqmap(parm->device);
+	}
+	if (ncpus && !parm->thread)
+		sd_cpubind(cpus[0]);
+
+	/* the cache settings go with the results, changed if asked */
+	if (parm->cache && !cache_ab 
+			&& sd_cacheset(disk->fd, &cache_want) < 0) {
+		tperr("init test failed\n");
+		exit(SD_ERR_SYS);
+	}
+	if (sd_cacheinfo(disk) < 0 && parm->cache) {
+		tperr("cache: no caching mode page on %s\n", parm->device);
+		tperr("init test failed\n");
+		exit(SD_ERR_SYS);
+	}
+	sd_xferinfo(disk);
+
+	/* the chunks of a partial coverage are placed anew every run */
+	sd_strataseed(((unsigned long long)time(NULL) << 20) ^ getpid());
+	if (parm->cover < 100)
+		tpout("Coverage: %d%% in strata of %d transfers\n", parm->cover,
+				STRATA_CHUNK);
+
+	/* data and backup buffers of every thread */
+	if (sd_poolinit(parm->block * parm->blocks, 
+			(parm->thread ? parm->thread : 1) * POOL_BUFS,
+			parm->numa, parm->huge) < 0) {
+		tperr("init test failed\n");
+		exit(SD_ERR_SYS);
+	}
+
+	/* count the io of every thread, shown live if asked */
+	sd_statwrap(disk);
+	sd_syncwrap(disk);
+	/* outermost, the latency counted doesn't include the pacing */
+	if (parm->rate || parm->slo) {
+		sd_pacewrap(disk);
+		sd_pacerate(parm->rate);
+	}
+	if (parm->board && sd_statboard(parm->board, disk, sd_expect(parm)) < 0)
+		parm->board = NULL;
+	if (parm->live || parm->board)
+		sd_statstart(parm->live ? parm->live : BOARD_SECS, parm->live);
+
 	tptout("%s: %s: %s: ...", progname, parm->device, parm->test);
 	
-	if ((do_test(disk, parm)) != SD_ERR_NO) {;
+	if ((cache_ab ? do_abtest(disk, parm) : naligns ? do_aligntest(disk, parm)
+			: parm->slo ? do_slotest(disk, parm)
+			: nzones ? do_zonetest(disk, parm)
+			: parm->scandb ? do_scantest(disk, parm)
+			: do_run(disk, parm)) != SD_ERR_NO) {;
 		if (disk->stat != SD_ERR_NO) {
 			tpout(" FAILED\n");
-			exit(disk->stat);
+			ret = disk->stat;
 		} else {
 			tpout(" failed\n");
-			exit(SD_ERR_SYS);
+			ret = SD_ERR_SYS;
 		}
+		sd_statstop(ret);
+		exit(ret);
 	}
-	tpout(" %d PASSED\n", parm->pass);
+	tpout(" %d PASSED\n", parm->time ? passes_run : parm->pass);
+	sd_statstop(ret);
 
+	sd_poolexit();
+	sd_cacherestore();
 	exit_test(disk);
 
 	exit(ret);
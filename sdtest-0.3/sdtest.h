@@ -13,6 +13,30 @@
  * 2008-03-14 changed MAX_BLK_SIZE to 4096, added 'blk' to hold size in blocks
  *            'bsget' and 'blkget' hook for different io method
  * 2008-06-10 replace 'size_t' with 'off_t' to hold disk size.
+ * 2026-10-19 added 'xfer' sgio transfer modes, 'bufget' and 'bufput' hook
+ *            for io method provided data buffer
+ *            added bsg device type and 'depth' of outstanding commands,
+ *            enlarged NUM_TESTS so that the tests table ends with null
+ *            added 'cpus' and 'numa' for thread affinity and local buffers
+ *            added 'huge' for huge page backed buffer pool
+ *            added 'live' interval of the stats collector
+ *            added 'board' slot of process status board
+ *            added 'sd_disp' dispenser of test space shared by threads
+ *            added file type of regular file targets, 'alloc' size to
+ *            preallocate them and 'files' of one file per thread
+ *            added 'flush' hook, 'sync' barrier mode and its cadence
+ *            added 'cache' mode page settings
+ *            raised MAX_BPT_SIZE to 64M, added 'cmdmax' bytes of one command
+ *            and 'maxget' hook for the limits the device reports
+ *            added 'pbs' physical block size and 'align' lowest aligned lba
+ *            raised MAX_BLK_SIZE to 64K, added 'align' offsets of test
+ *            added 'time' of a test repeating passes, 'deadline' of the
+ *            dispenser
+ *            added 'rate' of paced transfers and 'slo' latency target
+ *            added 'zones' of the zone profile
+ *            added STRATA_CHUNK of the stratified coverage
+ *            added 'scandb' of the incremental scrub
+ *            added 'deadline' of a timed test to the test parameters
  *
  */
 
@@ -21,22 +45,33 @@
 
 #include <sys/types.h>
 #include <pthread.h>
+#include <time.h>
 
 #include "version.h"
 
 /*
  * global definitaions
  */
-#define NUM_TESTS	9
+#define NUM_TESTS	16
 #define NUM_THREADS	16
 
+/* outstanding commands per thread */
+#define MAX_QDEPTH	256
+
 /* physical device has 512-byte sector */
 #define BASE_SEC_SIZE	512
-#define MAX_BLK_SIZE	4096
+#define MAX_BLK_SIZE	65536
 
-/* block per transfer */
+/* block per transfer, larger ones are split into commands */
 #define BPT_BLOCKS	128
-#define MAX_BPT_SIZE	64 * 1024
+#define MAX_BPT_SIZE	(64 * 1024 * 1024)
+
+/* most transfers per chunk claimed from the dispenser */
+#define DISP_CHUNK	256
+#define DISP_CLAIMS	8	/* at least claims per thread and pass */
+
+/* transfers of a chunk of every stratum of a partial coverage */
+#define STRATA_CHUNK	16
 
 /* disk types */
 enum {
@@ -45,6 +80,8 @@ enum {
 	SD_SCSI_CD,
 	SD_BLOCK,
 	SD_RAW,
+	SD_SCSI_BSG,
+	SD_FILE,
 	SD_OTHER,
 };
 
@@ -56,6 +93,8 @@ enum {
 #define CDROM_DISK	"cd"
 #define DVDROM_DISK	"dvd"
 #define CDRW_DISK	"sg"
+#define BSG_DISK	"bsg"
+#define FILE_DISK	"file"
 
 /* test names */
 #define SEQU_READ	"sread"
@@ -71,6 +110,22 @@ enum {
 #define INTERFACE	"interf"
 #define SELF_DIAG	"selfd"
 
+/* sgio data transfer modes */
+enum {
+	SD_XFER_COPY,	/* indirect io through the kernel buffer */
+	SD_XFER_MMAP,	/* mmap-ed sg reserved buffer, zero copy */
+	SD_XFER_DIO,	/* direct io into user memory */
+};
+
+/* durability barriers of writing tests */
+enum {
+	SD_SYNC_NONE,
+	SD_SYNC_FSYNC,	/* fsync, or synchronize cache by sgio */
+	SD_SYNC_FDATA,	/* fdatasync, or synchronize cache by sgio */
+	SD_SYNC_DSYNC,	/* every write synchronous, O_DSYNC */
+	SD_SYNC_FUA,	/* every write forced unit access */
+};
+
 /* 
  * test parameters
  */
@@ -93,6 +148,26 @@ struct test_parm {
 	int		backup; /* backup mode of test */
 	int		sgio;	/* use sgio to access */
 	int		direct;	/* use O_DIRECT I/O */
+	int		xfer;	/* sgio data transfer mode */
+	int		depth;	/* outstanding commands of bsg */
+	char *		cpus;	/* cpu list to bind threads to */
+	int		numa;	/* numa node of buffers, -1 for any */
+	int		huge;	/* huge pages backing buffers */
+	int		live;	/* seconds between live stats */
+	char *		board;	/* process board slot, "name:n" */
+	off_t		alloc;	/* bytes to preallocate the file to */
+	int		files;	/* one file per thread, "file.n" */
+	int		sync;	/* durability barrier of writes */
+	int		synops;	/* writes between flushes */
+	off_t		synbytes;/* or bytes written between flushes */
+	char *		cache;	/* caching mode page of the test */
+	char *		align;	/* offsets of the alignment test */
+	int		time;	/* seconds to repeat passes for, 0 for none */
+	const struct timespec *deadline; /* end of a timed run, NULL for none */
+	unsigned	rate;	/* transfers per second, 0 for any */
+	char *		slo;	/* latency target of the rate search */
+	char *		zones;	/* regions of the zone profile, "n[:size]" */
+	char *		scandb;	/* age of regions to rescan, "age[:dir]" */
 	int		nopro;  /* don't show process percentage */
 };
 
@@ -130,6 +205,9 @@ struct sd_device {
 	int		bs;	/* property: device block size */
 	off_t		blk;	/* property: device size in blocks */
 	off_t		size;	/* property: device size in bytes */
+	int		cmdmax;	/* property: bytes of a command, 0 for any */
+	int		pbs;	/* property: physical block size */
+	off_t		align;	/* property: lowest aligned lba */
 	//size_t		blk;	/* property: device size in blocks */
 	//size_t		size;	/* property: device size in bytes */
 
@@ -143,6 +221,10 @@ struct sd_device {
 	int (*write)(struct sd_device *, void *, size_t);
 	int (*bsget)(struct sd_device *);
 	int (*blkget)(struct sd_device *);
+	int (*maxget)(struct sd_device *);
+	char *(*bufget)(struct sd_device *, size_t);
+	void (*bufput)(struct sd_device *, char *, size_t);
+	int (*flush)(struct sd_device *);
 	
 	enum sd_err	stat;	/* keep latest io status */
 
@@ -151,6 +233,23 @@ struct sd_device {
 	struct sd_test tests[NUM_TESTS];
 };
 
+/*
+ * dispenser of the test space shared by threads, every thread claims
+ * the next chunk of transfers of a pass from the cursor of that pass,
+ * so a slow region doesn't leave the other threads idle
+ */
+struct sd_disp {
+	off_t		start;	/* property: start position of test space */
+	off_t		size;	/* property: byte size of test space */
+	off_t		xfer;	/* property: bytes of every transfer */
+	off_t		total;	/* property: transfers of one pass */
+	off_t		chunk;	/* property: transfers of every claim */
+	int		pass;	/* property: passes */
+
+	off_t *		next;	/* next transfer of every pass */
+	const struct timespec *deadline; /* no claims past it, NULL for none */
+};
+
 /*
  * core partition structure
  */
@@ -171,6 +270,9 @@ struct sd_part {
 	struct test_parm *parm; /* local test_parm structure of partition */
 	
 	struct sd_test *test;	/* the test pointer of this partition */
+
+	struct sd_disp *disp;	/* shared dispenser, NULL for a fixed piece */
+	int		pass;	/* current pass, from 0 */
 };
 
 /*
@@ -192,6 +294,7 @@ struct sd_thread {
 	struct sd_part	*part;  /* one partition per thread */
 
 	struct test_parm parm;	/* a copy of test_parm per thread */
+	char		file[256]; /* own file of thread, "file.n" */
 };
 
 /*
@@ -0,0 +1,441 @@
+/* stats.c
+ *
+ * Author: Xiang-Yu Wang <rain_wang@jabil.com>
+ *
+ * Copyright (c) 2008 Jabil, Inc.
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * 2026-10-19 made initial version, io threads count bytes, transfers,
+ *            errors and latency into their own slot without locks, a
+ *            collector thread merges the slots for the live display
+ *            the collector also publishes to the status board of
+ *            process, the offset of the last seek is kept for it
+ *            flushes are timed into a histogram apart from the writes
+ *            'sd_statdiff' of two snapshots for the cache A/B test
+ *            the percentiles come from log-linear buckets, interpolated,
+ *            the power of two buckets stay for the histograms
+ *            the seconds and MB/s of the run on the total line
+ *
+ */
+
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/types.h>
+
+#include "sdtest.h"
+#include "utils.h"
+#include "stats.h"
+#include "board.h"
+
+/* single writer per slot: relaxed load and store, no locked op */
+#define ST_ADD(x, n)	__atomic_store_n(&(x), \
+		__atomic_load_n(&(x), __ATOMIC_RELAXED) + (n), __ATOMIC_RELAXED)
+#define ST_GET(x)	__atomic_load_n(&(x), __ATOMIC_RELAXED)
+
+static struct sd_stat stats[NUM_THREADS];
+static __thread struct sd_stat *stat_self = NULL;
+
+/* the io hooks being counted */
+static int (*io_seek)(struct sd_device *, off_t);
+static int (*io_read)(struct sd_device *, void *, size_t);
+static int (*io_write)(struct sd_device *, void *, size_t);
+static int (*io_flush)(struct sd_device *);
+
+/* the collector */
+static pthread_t collector;
+static pthread_mutex_t col_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t col_cond = PTHREAD_COND_INITIALIZER;
+static int col_stop = 0;
+static int col_run = 0;
+static int col_secs = 0;
+static int col_print = 0;
+static unsigned long long col_start = 0;	/* nsec the run started */
+
+/* the status board slot of this child */
+static struct sd_slot *board = NULL;
+static struct sd_slot bd_self;
+static int bd_bs = BASE_SEC_SIZE;
+
+static inline unsigned long long sd_nsec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static inline int sd_statbkt(unsigned long long ns)
+{
+	unsigned long long us = ns / 1000;
+	int b = us ? 64 - __builtin_clzll(us) : 0;
+
+	return (b >= LAT_BUCKETS) ? LAT_BUCKETS - 1 : b;
+}
+
+static inline int sd_statfbkt(unsigned long long ns)
+{
+	unsigned long long us = ns / 1000;
+	int e;
+
+	if (us < LAT_SUB)
+		return us;
+	e = 63 - __builtin_clzll(us);
+	if (e >= LAT_BUCKETS)
+		return LAT_FINE - 1;
+	return (e - LAT_SUBBITS + 1) * LAT_SUB
+		+ (us >> (e - LAT_SUBBITS)) - LAT_SUB;
+}
+
+/* the lowest usec and the usec width of a log-linear bucket */
+static void sd_statfrange(int f, unsigned long long *lo,
+		unsigned long long *width)
+{
+	int e = f / LAT_SUB + LAT_SUBBITS - 1;
+
+	if (f < LAT_SUB) {
+		*lo = f;
+		*width = 1;
+		return;
+	}
+	*width = 1ULL << (e - LAT_SUBBITS);
+	*lo = (unsigned long long)(LAT_SUB + f % LAT_SUB) << (e - LAT_SUBBITS);
+}
+
+static inline void sd_statio(int wr, size_t size, int res,
+		unsigned long long ns)
+{
+	struct sd_stat *st = stat_self ? stat_self : &stats[0];
+	int b = sd_statbkt(ns);
+
+	if (res < 0)
+		ST_ADD(st->errs, 1);
+	else if (wr) {
+		ST_ADD(st->bytes_wr, size);
+		ST_ADD(st->ops_wr, 1);
+	} else {
+		ST_ADD(st->bytes_rd, size);
+		ST_ADD(st->ops_rd, 1);
+	}
+	ST_ADD(st->lat[b], 1);
+	ST_ADD(st->fine[sd_statfbkt(ns)], 1);
+}
+
+static int st_seek(struct sd_device *sd, off_t offset)
+{
+	struct sd_stat *st = stat_self ? stat_self : &stats[0];
+
+	__atomic_store_n(&st->pos, offset, __ATOMIC_RELAXED);
+	return io_seek(sd, offset);
+}
+
+static int st_read(struct sd_device *sd, void *buf, size_t size)
+{
+	unsigned long long t = sd_nsec();
+	int res = io_read(sd, buf, size);
+
+	sd_statio(0, size, res, sd_nsec() - t);
+	return res;
+}
+
+static int st_write(struct sd_device *sd, void *buf, size_t size)
+{
+	unsigned long long t = sd_nsec();
+	int res = io_write(sd, buf, size);
+
+	sd_statio(1, size, res, sd_nsec() - t);
+	return res;
+}
+
+static int st_flush(struct sd_device *sd)
+{
+	struct sd_stat *st = stat_self ? stat_self : &stats[0];
+	unsigned long long t = sd_nsec();
+	int res = io_flush(sd);
+
+	t = sd_nsec() - t;
+	if (res < 0)
+		ST_ADD(st->errs, 1);
+	else {
+		ST_ADD(st->ops_fl, 1);
+		ST_ADD(st->lat_fl[sd_statbkt(t)], 1);
+		ST_ADD(st->fine_fl[sd_statfbkt(t)], 1);
+	}
+	return res;
+}
+
+void sd_statwrap(struct sd_device *disk)
+{
+	if (disk->read == st_read)
+		return;
+	io_seek = disk->seek;
+	io_read = disk->read;
+	io_write = disk->write;
+	io_flush = disk->flush;
+	disk->seek = st_seek;
+	disk->read = st_read;
+	disk->write = st_write;
+	if (disk->flush)
+		disk->flush = st_flush;
+}
+
+void sd_statbind(int n)
+{
+	stat_self = &stats[n % NUM_THREADS];
+}
+
+void sd_statsnap(struct sd_stat *sum)
+{
+	struct sd_stat *st;
+	int i, b;
+
+	memset(sum, 0, sizeof(*sum));
+	for (i = 0; i < NUM_THREADS; i++) {
+		st = &stats[i];
+		sum->bytes_rd += ST_GET(st->bytes_rd);
+		sum->bytes_wr += ST_GET(st->bytes_wr);
+		sum->ops_rd += ST_GET(st->ops_rd);
+		sum->ops_wr += ST_GET(st->ops_wr);
+		sum->errs += ST_GET(st->errs);
+		sum->ops_fl += ST_GET(st->ops_fl);
+		for (b = 0; b < LAT_BUCKETS; b++) {
+			sum->lat[b] += ST_GET(st->lat[b]);
+			sum->lat_fl[b] += ST_GET(st->lat_fl[b]);
+		}
+		for (b = 0; b < LAT_FINE; b++) {
+			sum->fine[b] += ST_GET(st->fine[b]);
+			sum->fine_fl[b] += ST_GET(st->fine_fl[b]);
+		}
+	}
+}
+
+void sd_statadd(struct sd_stat *st, unsigned long long us)
+{
+	st->lat[sd_statbkt(us * 1000)]++;
+	st->fine[sd_statfbkt(us * 1000)]++;
+}
+
+/*
+ * the latency under which pct percent of the transfers are, linear in
+ * the bucket holding it, the transfers of a bucket taken as spread
+ * evenly over its width
+ */
+static unsigned long long sd_statpct(unsigned long long *fine, int pct)
+{
+	unsigned long long total = 0, n = 0, lo, width;
+	double rank;
+	int f;
+
+	for (f = 0; f < LAT_FINE; f++)
+		total += fine[f];
+	if (!total)
+		return 0;
+	rank = (double)total * pct / 100;
+	for (f = 0; f < LAT_FINE - 1; f++) {
+		if (fine[f] && n + fine[f] >= rank)
+			break;
+		n += fine[f];
+	}
+	sd_statfrange(f, &lo, &width);
+	if (!fine[f])
+		return lo + width;
+	return lo + (unsigned long long)(width * (rank - n) / fine[f] + 0.5);
+}
+
+unsigned long long sd_statlat(struct sd_stat *st, int pct)
+{
+	return sd_statpct(st->fine, pct);
+}
+
+unsigned long long sd_statflat(struct sd_stat *st, int pct)
+{
+	return sd_statpct(st->fine_fl, pct);
+}
+
+int sd_statboard(const char *spec, struct sd_device *disk,
+		unsigned long long expect)
+{
+	struct test_parm *p = disk->parm;
+
+	board = sd_boardslot(spec);
+	if (!board)
+		return SD_ERR;
+
+	/* the counters of process are kept */
+	sd_boardget(board, &bd_self);
+	bd_self.pid = getpid();
+	bd_self.state = BD_RUN;
+	bd_self.res = SD_ERR_NO;
+	snprintf(bd_self.device, sizeof(bd_self.device), "%s", p->device);
+	snprintf(bd_self.test, sizeof(bd_self.test), "%s", p->test);
+	bd_self.start = p->start;
+	bd_self.size = p->size;
+	bd_self.bytes = 0;
+	bd_self.expect = expect;
+	bd_self.lba = p->start / disk->bs;
+	bd_self.errs = 0;
+	bd_self.mbps = 0;
+	bd_self.secs = 0;
+	bd_bs = disk->bs;
+	sd_boardput(board, &bd_self);
+
+	return SD_ERR_NO;
+}
+
+static void sd_statpub(struct sd_stat *now, struct sd_stat *last, double secs,
+		double elapsed)
+{
+	unsigned long long bytes = now->bytes_rd + now->bytes_wr;
+
+	bd_self.bytes = bytes;
+	bd_self.errs = now->errs;
+	bd_self.lba = ST_GET(stats[0].pos) / bd_bs;
+	bd_self.secs = elapsed;
+	if (secs > 0)
+		bd_self.mbps = (bytes - last->bytes_rd - last->bytes_wr)
+				/ secs / 1000000;
+	sd_boardput(board, &bd_self);
+}
+
+void sd_statdiff(struct sd_stat *d, struct sd_stat *now, struct sd_stat *last)
+{
+	int b;
+
+	d->bytes_rd = now->bytes_rd - last->bytes_rd;
+	d->bytes_wr = now->bytes_wr - last->bytes_wr;
+	d->ops_rd = now->ops_rd - last->ops_rd;
+	d->ops_wr = now->ops_wr - last->ops_wr;
+	d->errs = now->errs - last->errs;
+	d->ops_fl = now->ops_fl - last->ops_fl;
+	for (b = 0; b < LAT_BUCKETS; b++) {
+		d->lat[b] = now->lat[b] - last->lat[b];
+		d->lat_fl[b] = now->lat_fl[b] - last->lat_fl[b];
+	}
+	for (b = 0; b < LAT_FINE; b++) {
+		d->fine[b] = now->fine[b] - last->fine[b];
+		d->fine_fl[b] = now->fine_fl[b] - last->fine_fl[b];
+	}
+}
+
+/* print the difference of two snapshots over secs */
+static void sd_statpr(struct sd_stat *now, struct sd_stat *last, double secs,
+		double elapsed)
+{
+	struct sd_stat d;
+	unsigned long long bytes, ops;
+
+	sd_statdiff(&d, now, last);
+	bytes = d.bytes_rd + d.bytes_wr;
+	ops = d.ops_rd + d.ops_wr;
+
+	tpterr("live %.0fs: %.2f MB/s %.0f tps, total %llu MB, errors %llu, "
+			"lat p50 %lluus p99 %lluus\n", elapsed,
+			secs > 0 ? bytes / secs / 1000000 : 0.0,
+			secs > 0 ? ops / secs : 0.0,
+			(now->bytes_rd + now->bytes_wr) / 1000000, now->errs,
+			sd_statlat(&d, 50), sd_statlat(&d, 99));
+	if (d.ops_fl)
+		tpterr("live %.0fs: %.0f flushes/s, flush lat p50 %lluus "
+				"p99 %lluus\n", elapsed,
+				secs > 0 ? d.ops_fl / secs : 0.0,
+				sd_statflat(&d, 50), sd_statflat(&d, 99));
+}
+
+static void *sd_collect(void *arg)
+{
+	struct sd_stat now, last;
+	unsigned long long start, t, tl;
+	struct timespec ts;
+
+	sd_statsnap(&last);
+	start = tl = sd_nsec();
+
+	pthread_mutex_lock(&col_lock);
+	while (!col_stop) {
+		clock_gettime(CLOCK_REALTIME, &ts);
+		ts.tv_sec += col_secs;
+		pthread_cond_timedwait(&col_cond, &col_lock, &ts);
+		if (col_stop)
+			break;
+
+		/* the io threads are never waited for, only read */
+		sd_statsnap(&now);
+		t = sd_nsec();
+		if (col_print)
+			sd_statpr(&now, &last, (t - tl) / 1e9, (t - start) / 1e9);
+		if (board)
+			sd_statpub(&now, &last, (t - tl) / 1e9, (t - start) / 1e9);
+		last = now;
+		tl = t;
+	}
+	pthread_mutex_unlock(&col_lock);
+
+	return NULL;
+}
+
+int sd_statstart(int secs, int print)
+{
+	int res;
+
+	col_secs = secs;
+	col_print = print;
+	col_stop = 0;
+	col_start = sd_nsec();
+	res = pthread_create(&collector, NULL, sd_collect, NULL);
+	if (res) {
+		tperr("live: can't start collector (%s)\n", strerror(res));
+		return SD_ERR;
+	}
+	col_run = 1;
+
+	return SD_ERR_NO;
+}
+
+void sd_statstop(int res)
+{
+	struct sd_stat sum;
+	double secs;
+
+	if (!col_run)
+		return;
+	secs = (sd_nsec() - col_start) / 1e9;
+	pthread_mutex_lock(&col_lock);
+	col_stop = 1;
+	pthread_cond_signal(&col_cond);
+	pthread_mutex_unlock(&col_lock);
+	pthread_join(collector, NULL);
+	col_run = 0;
+
+	sd_statsnap(&sum);
+	if (board) {
+		bd_self.bytes = sum.bytes_rd + sum.bytes_wr;
+		bd_self.errs = sum.errs;
+		bd_self.mbps = 0;
+		bd_self.state = res ? BD_FAIL : BD_PASS;
+		bd_self.res = res;
+		sd_boardput(board, &bd_self);
+	}
+	if (!col_print)
+		return;
+	tpterr("total: read %llu MB %llu tsf, written %llu MB %llu tsf, "
+			"errors %llu, lat p50 %lluus p99 %lluus, in %.3f s "
+			"%.2f MB/s %.0f tps\n",
+			sum.bytes_rd / 1000000, sum.ops_rd,
+			sum.bytes_wr / 1000000, sum.ops_wr, sum.errs,
+			sd_statlat(&sum, 50), sd_statlat(&sum, 99), secs,
+			secs > 0 ? (sum.bytes_rd + sum.bytes_wr) / secs / 1e6 : 0.0,
+			secs > 0 ? (sum.ops_rd + sum.ops_wr) / secs : 0.0);
+	/* apart from the total line, which scripts parse */
+	if (sum.ops_fl)
+		tpterr("flush: %llu flushes, %llu writes per flush, "
+				"lat p50 %lluus p99 %lluus\n",
+				sum.ops_fl, sum.ops_wr / sum.ops_fl,
+				sd_statflat(&sum, 50), sd_statflat(&sum, 99));
+}
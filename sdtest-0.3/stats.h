@@ -0,0 +1,84 @@
+/* stats.h
+ *
+ * Author: Xiang-Yu Wang <rain_wang@jabil.com>
+ *
+ * Copyright (c) 2008 Jabil, Inc.
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * 2026-10-19 made initial version
+ *            added 'pos' of the last seek and the process board
+ *            added flushes with a latency histogram of their own
+ *            added 'sd_statdiff'
+ *            added log-linear latency buckets of the percentiles
+ *
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <sys/types.h>
+
+#include "sdtest.h"
+
+#define CACHE_LINE	64
+
+/* latency buckets, bucket n holds [2^(n-1), 2^n) usec */
+#define LAT_BUCKETS	32
+
+/*
+ * log-linear latency buckets of the percentiles, every power of two
+ * split into LAT_SUB, exact under 2 * LAT_SUB usec; a percentile is
+ * within 1/LAT_SUB of the latency, interpolated in its bucket
+ */
+#define LAT_SUBBITS	4
+#define LAT_SUB		(1 << LAT_SUBBITS)
+#define LAT_FINE	((LAT_BUCKETS - LAT_SUBBITS + 1) * LAT_SUB)
+
+/*
+ * the io counters of one thread, only written by that thread; the
+ * slots are cache line aligned so that threads don't share lines
+ */
+struct sd_stat {
+	unsigned long long bytes_rd;	/* bytes read */
+	unsigned long long bytes_wr;	/* bytes written */
+	unsigned long long ops_rd;	/* read transfers */
+	unsigned long long ops_wr;	/* write transfers */
+	unsigned long long errs;	/* failed transfers */
+	off_t pos;			/* byte offset of the last seek */
+	unsigned long long lat[LAT_BUCKETS];	/* latency histogram */
+	unsigned long long ops_fl;	/* flushes */
+	unsigned long long lat_fl[LAT_BUCKETS];	/* flush latency */
+	unsigned long long fine[LAT_FINE];	/* log-linear latency */
+	unsigned long long fine_fl[LAT_FINE];	/* of the flushes */
+} __attribute__((aligned(CACHE_LINE)));
+
+/* count the io through the read, write and flush hooks of the device */
+extern void sd_statwrap(struct sd_device *);
+
+/* the calling thread counts into slot n */
+extern void sd_statbind(int);
+
+/* merge all slots into one */
+extern void sd_statsnap(struct sd_stat *);
+
+/* the difference of two snapshots, now - last */
+extern void sd_statdiff(struct sd_stat *, struct sd_stat *, struct sd_stat *);
+
+/* count a latency in usec into a private sd_stat, e.g. of a profile */
+extern void sd_statadd(struct sd_stat *, unsigned long long);
+
+/* latency of a percentile (0-100) in usec */
+extern unsigned long long sd_statlat(struct sd_stat *, int);
+extern unsigned long long sd_statflat(struct sd_stat *, int);
+
+/* publish to the process board slot "name:n", bytes expected in total */
+extern int sd_statboard(const char *, struct sd_device *, unsigned long long);
+
+/* collector thread every interval seconds, printing if asked */
+extern int sd_statstart(int, int);
+extern void sd_statstop(int);
+
+#endif /* STATS_H */
@@ -0,0 +1,163 @@
+#!/bin/sh
+#
+# sweep.sh - transfer size, queue depth and thread sweep of sdtest
+#
+# Copyright (c) 2008 Jabil, Inc.
+#
+# This code is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 as
+# published by the Free Software Foundation.
+#
+# 2026-10-19 made initial version, every point of the matrix runs one
+#            workload for a fixed time, the table and the knee of every
+#            transfer size are written as csv or json
+#            the points are parsed by total.sh, shared with bench.sh
+#
+# usage: sweep.sh -d device [-t test] [-g "blocks ..."] [-e "depths ..."]
+#                 [-r "threads ..."] [-T seconds] [-s MiB] [-k percent]
+#                 [-x "sdtest options"] [-o sweep.csv|sweep.json]
+#
+# the points of a transfer size are taken by concurrency (threads times
+# depth); the knee is the last point before the one that adds less than
+# the knee percent (default 10) of throughput while its latency grows.
+# the depths only apply to bsg, the other backends run depth 1.
+#
+
+SDTEST=${SDTEST:-./sdtest}
+. "$(dirname "$0")/total.sh"
+
+DEVICE=
+TEST=rread
+BLOCKS="8 16 32 64 128 256 1024"
+DEPTHS="1"
+THREADS="1 2 4 8 16"
+TIME=10
+SIZE=1024	# MiB of the test space, passes repeat till the time is up
+KNEE=10
+OPTS=
+OUT=sweep.csv
+
+usage()
+{
+	echo "usage: $0 -d device [-t test] [-g \"blocks ...\"] [-e \"depths ...\"] [-r \"threads ...\"] [-T seconds] [-s MiB] [-k percent] [-x \"sdtest options\"] [-o sweep.csv|sweep.json]"
+	exit 255
+}
+
+while getopts "d:t:g:e:r:T:s:k:x:o:h" opt; do
+	case $opt in
+	d) DEVICE=$OPTARG ;;
+	t) TEST=$OPTARG ;;
+	g) BLOCKS=$OPTARG ;;
+	e) DEPTHS=$OPTARG ;;
+	r) THREADS=$OPTARG ;;
+	T) TIME=$OPTARG ;;
+	s) SIZE=$OPTARG ;;
+	k) KNEE=$OPTARG ;;
+	x) OPTS=$OPTARG ;;
+	o) OUT=$OPTARG ;;
+	*) usage ;;
+	esac
+done
+[ -z "$DEVICE" ] && usage
+
+if [ "$(id -u)" != 0 ]; then
+	echo "$0: must be run as root" >&2
+	exit 255
+fi
+
+TMP=$(mktemp /tmp/sweep.XXXXXX) || exit 254
+trap 'rm -f "$TMP"' EXIT
+trap 'exit 255' INT TERM
+
+case "$DEVICE" in
+/dev/bsg/*) ;;
+*)	[ "$DEPTHS" != 1 ] && echo "$0: depths only apply to bsg, use 1" >&2
+	DEPTHS=1 ;;
+esac
+
+INFO=$($SDTEST -d "$DEVICE" $OPTS -i 2>/dev/null) || {
+	echo "$0: $DEVICE: no device info" >&2
+	exit 254
+}
+BS=$(echo "$INFO" | sed -n 's/^Block: logical \([0-9]*\).*/\1/p')
+[ -z "$BS" ] && BS=512
+VERSION=$($SDTEST -v 2>/dev/null)
+[ -z "$VERSION" ] && VERSION=unknown
+
+# one point, prints "mbps iops p50 p99" from the total line of the stats
+run_point()
+{
+	run_total "$DEVICE" -t "$TEST" -s "${SIZE}m" -T "$TIME" $OPTS "$@"
+}
+
+# points as "blocks bytes threads depth mbps iops p50 p99" in $TMP
+printf "%8s %10s %8s %6s %10s %10s %8s %8s\n" blocks bytes threads depth \
+	MB/s iops p50_us p99_us
+for g in $BLOCKS; do
+for q in $DEPTHS; do
+for r in $THREADS; do
+	res=$(run_point -g "$g" -e "$q" -r "$r")
+	if [ -z "$res" ]; then
+		echo "$TEST g$g q$q t$r: failed, skipped" >&2
+		continue
+	fi
+	set -- $res
+	echo "$g $((g * BS)) $r $q $1 $2 $3 $4" >> "$TMP"
+	printf "%8s %10s %8s %6s %10s %10s %8s %8s\n" "$g" $((g * BS)) "$r" \
+		"$q" "$1" "$2" "$3" "$4"
+done
+done
+done
+
+# a knee column, 1 on the knee of every transfer size
+knee()
+{
+	awk '{
+		c = ($3 ? $3 : 1) * $4
+		print $1, c, NR, $0
+	}' "$TMP" | sort -n -k1,1 -k2,2 -k3,3 | cut -d' ' -f4- | awk -v k="$KNEE" '
+	function flush() {
+		for (i = 1; i <= n; i++)
+			print line[i], (i == kn) ? 1 : 0
+		n = 0
+	}
+	{
+		if ($1 != g) {
+			flush()
+			g = $1; kn = 0
+		}
+		line[++n] = $0
+		mb[n] = $5; p50[n] = $7; p99[n] = $8
+		# throughput stops scaling while the latency keeps growing
+		if (n > 1 && !kn && mb[n] < mb[n - 1] * (1 + k / 100) \
+				&& (p50[n] > p50[n - 1] || p99[n] > p99[n - 1]))
+			kn = n - 1
+	}
+	END { flush() }'
+}
+
+knee > "$TMP.k" && mv "$TMP.k" "$TMP"
+awk '$9 == 1 { printf "knee: %s bytes at %s threads depth %s, %s MB/s %s iops p50 %sus p99 %sus\n", $2, $3, $4, $5, $6, $7, $8 }' "$TMP"
+awk '{ print $1 }' "$TMP" | sort -un | while read g; do
+	grep -q "^$g .* 1\$" "$TMP" || \
+		echo "knee: $((g * BS)) bytes none, scaling or flat latency"
+done
+
+case "$OUT" in
+*.json)
+	printf '{\n "version": "%s",\n "date": "%s",\n "host": "%s",\n "kernel": "%s",\n "device": "%s",\n "test": "%s",\n "time": %s,\n "size": "%s",\n "options": "%s",\n "results": [\n' \
+		"$VERSION" "$(date +%Y-%m-%dT%H:%M:%S)" "$(uname -n)" \
+		"$(uname -r)" "$DEVICE" "$TEST" "$TIME" "$SIZE" "$OPTS" > "$OUT"
+	awk '{
+		if (NR > 1) printf ",\n"
+		printf "  {\"blocks\": %s, \"bytes\": %s, \"threads\": %s, \"depth\": %s, \"mbps\": %s, \"iops\": %s, \"p50_us\": %s, \"p99_us\": %s, \"knee\": %s}", \
+			$1, $2, $3, $4, $5, $6, $7, $8, $9 ? "true" : "false"
+	}' "$TMP" >> "$OUT"
+	printf '\n ]\n}\n' >> "$OUT"
+	;;
+*)
+	echo "blocks,bytes,threads,depth,mbps,iops,p50_us,p99_us,knee" > "$OUT"
+	tr ' ' ',' < "$TMP" >> "$OUT"
+	;;
+esac
+echo "sweep written to $OUT"
@@ -0,0 +1,74 @@
+/* sync.c
+ *
+ * Author: Xiang-Yu Wang <rain_wang@jabil.com>
+ *
+ * Copyright (c) 2008 Jabil, Inc.
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * 2026-10-19 made initial version, writes are followed by a flush of
+ *            the device at a cadence of writes or bytes, counted per
+ *            thread so that threads flush on their own
+ *
+ */
+
+#include <unistd.h>
+#include <stdio.h>
+#include <sys/types.h>
+
+#include "sdtest.h"
+#include "utils.h"
+#include "sync.h"
+
+/* the write hook being followed by flushes */
+static int (*io_write)(struct sd_device *, void *, size_t);
+
+/* writes and bytes since the last flush of this thread */
+static __thread int syn_ops = 0;
+static __thread off_t syn_bytes = 0;
+
+static int sy_write(struct sd_device *sd, void *buf, size_t size)
+{
+	struct test_parm *p = sd->parm;
+	int res = io_write(sd, buf, size);
+
+	if (res < 0)
+		return res;
+	syn_ops++;
+	syn_bytes += size;
+	if ((p->synbytes && syn_bytes >= p->synbytes)
+			|| (!p->synbytes && syn_ops >= p->synops)) {
+		syn_ops = 0;
+		syn_bytes = 0;
+		if (sd->flush(sd) < 0) {
+			tperr("sync: flush failed\n");
+			if (sd->stat == SD_ERR_NO)
+				sd->stat = SD_ERR_SYS;
+			return SD_ERR;
+		}
+	}
+	return res;
+}
+
+int sd_syncwrap(struct sd_device *disk)
+{
+	struct test_parm *p = disk->parm;
+
+	if (p->sync != SD_SYNC_FSYNC && p->sync != SD_SYNC_FDATA)
+		return SD_ERR_NO;
+	if (!disk->flush) {
+		tperr("sync: no flush on this device, ignored\n");
+		p->sync = SD_SYNC_NONE;
+		return SD_ERR;
+	}
+	if (disk->write == sy_write)
+		return SD_ERR_NO;
+	if (p->synops <= 0)
+		p->synops = 1;
+	io_write = disk->write;
+	disk->write = sy_write;
+
+	return SD_ERR_NO;
+}
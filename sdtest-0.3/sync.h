@@ -0,0 +1,27 @@
+/* sync.h
+ *
+ * Author: Xiang-Yu Wang <rain_wang@jabil.com>
+ *
+ * Copyright (c) 2008 Jabil, Inc.
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * 2026-10-19 made initial version
+ *
+ */
+
+#ifndef SYNC_H
+#define SYNC_H
+
+#include "sdtest.h"
+
+/* 
+ * flush through the flush hook of the device every 'synops' writes or
+ * 'synbytes' bytes written by a thread, as the sync mode of the test
+ * parameters asks; the per write modes need nothing here
+ */
+extern int sd_syncwrap(struct sd_device *);
+
+#endif /* SYNC_H */
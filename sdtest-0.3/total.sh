@@ -0,0 +1,38 @@
+#
+# total.sh - one run of sdtest and its total line, sourced by bench.sh
+#            and sweep.sh
+#
+# Copyright (c) 2008 Jabil, Inc.
+#
+# This code is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 as
+# published by the Free Software Foundation.
+#
+# 2026-10-19 made initial version
+#
+# the throughput is the one sdtest measures over the test itself, not
+# over the process with its start, device probing and buffer setup.
+#
+
+SDTEST=${SDTEST:-./sdtest}
+
+# run_total device options ..., prints "mbps tps p50 p99" of the run
+run_total()
+{
+	dev=$1
+	shift
+	line=$($SDTEST -d "$dev" -q 2 -l 3600 "$@" 2>&1 >/dev/null) || return 1
+	line=$(echo "$line" | grep "total:")
+	[ -z "$line" ] && return 1
+	echo "$line" | awk '{
+		for (i = 1; i < NF; i++) {
+			if ($(i + 1) == "MB/s") mbps = $i
+			if ($(i + 1) == "tps") tps = $i
+			if ($i == "p50") p50 = $(i + 1)
+			if ($i == "p99") p99 = $(i + 1)
+		}
+		sub("us", "", p50); sub("us,", "", p99); sub("us", "", p99)
+		if (mbps == "") exit 1
+		printf "%s %s %s %s\n", mbps, tps, p50, p99
+	}'
+}
@@ -9,6 +9,15 @@
  * published by the Free Software Foundation.
  *
  * 2008-01-17 made initial version
+ * 2026-10-19 added dispenser of test space, 'sd_dispget' claims a chunk
+ *            by one atomic add on the cursor of the pass
+ *            moved the pattern fill and compare loops of the algorithms
+ *            here, so that mbench can time them
+ *            no claims past the deadline of a timed test
+ *            'sd_stratum' spreads the transfers of a partial coverage
+ *            over the whole test space
+ *            'sd_randxfer' places a random transfer in the test space
+ *            'sd_pastdue' of the deadline, shared by all timed loops
  *
  */
 
@@ -59,6 +68,15 @@ off_t sd_randget(off_t range)
 	return (1 + (double) (range - 1) * r / (RAND_MAX + 1.0));
 }
 
+/* offset of a random whole transfer of xfer bytes in span bytes */
+off_t sd_randxfer(off_t span, off_t xfer)
+{
+	off_t n = span / xfer;
+
+	/* sd_randget is within 1 to range - 1 */
+	return n > 1 ? (sd_randget(n + 1) - 1) * xfer : 0;
+}
+
 int sd_bitss(int w)
 {
 	int b = 0;
@@ -126,6 +144,136 @@ size_t sd_bytebox(char *input, int b)
 	return num;
 }
 
+void sd_patfill(char *buf, int len, unsigned pattern)
+{
+	int i;
+
+	for (i = 0; i < len; i += 4) {
+		buf[i + 0] = (char)(pattern >> 24);
+		buf[i + 1] = (char)(pattern >> 16);
+		buf[i + 2] = (char)(pattern >> 8);
+		buf[i + 3] = (char)pattern;
+	}
+}
+
+/* 0 if the first len bytes (whole words) hold the pattern, -1 if not */
+int sd_patcmp(const char *buf, int len, unsigned pattern)
+{
+	int i;
+
+	for (i = 0; i + 4 <= len; i += 4) {
+		if ((buf[i] == (char)(pattern >> 24)) &&
+			(buf[i + 1] == (char)(pattern >> 16)) &&
+			(buf[i + 2] == (char)(pattern >> 8)) &&
+			(buf[i + 3] == (char)pattern))
+			continue;
+		return -1;
+	}
+	return 0;
+}
+
+int sd_dispinit(struct sd_disp *disp, off_t start, off_t size, off_t xfer,
+		int cover, int pass, int threads)
+{
+	disp->start = start;
+	disp->size  = size;
+	disp->xfer  = xfer;
+	/* as many transfers as the unthreaded test of the space, at least one */
+	disp->total = size / xfer * cover / 100;
+	if (disp->total < 1)
+		disp->total = 1;
+	disp->chunk = disp->total / (threads * DISP_CLAIMS);
+	if (disp->chunk > DISP_CHUNK)
+		disp->chunk = DISP_CHUNK;
+	if (disp->chunk < 1)
+		disp->chunk = 1;
+	disp->pass  = pass;
+	disp->deadline = NULL;
+	disp->next  = calloc(pass ? pass : 1, sizeof(off_t));
+	if (!disp->next)
+		return SD_ERR;
+
+	return SD_ERR_NO;
+}
+
+void sd_dispexit(struct sd_disp *disp)
+{
+	free(disp->next);
+	disp->next = NULL;
+}
+
+/* the chunks of a run are placed by this, the same for all threads */
+static unsigned long long strata_seed = 0;
+
+void sd_strataseed(unsigned long long seed)
+{
+	strata_seed = seed;
+}
+
+/* splitmix64 of the seed and a stratum, a place without shared state */
+static unsigned long long sd_stratamix(off_t s)
+{
+	unsigned long long z = strata_seed + (s + 1) * 0x9e3779b97f4a7c15ULL;
+
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+/*
+ * the transfer of the space of n transfers to test as the k-th of a
+ * partial coverage of total ones: the space is divided into strata of
+ * one chunk of STRATA_CHUNK transfers each, the chunk at a random place
+ * of its stratum, so a scan of a few percent samples the whole surface;
+ * a full coverage is tested in order as before
+ */
+off_t sd_stratum(off_t k, off_t total, off_t n)
+{
+	off_t c = STRATA_CHUNK, strata, s, lo, len;
+
+	if (total >= n || n <= 0)
+		return k;
+	if (c > total)
+		c = total;
+	strata = (total + c - 1) / c;
+	s = k / c;
+	lo = s * n / strata;
+	len = (s + 1) * n / strata - lo;
+	if (len > c)
+		lo += sd_stratamix(s) % (len - c + 1);
+
+	return lo + k % c;
+}
+
+int sd_pastdue(const struct timespec *deadline)
+{
+	struct timespec now;
+
+	if (!deadline)
+		return 0;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec > deadline->tv_sec || (now.tv_sec == deadline->tv_sec
+			&& now.tv_nsec >= deadline->tv_nsec);
+}
+
+/* the first transfer of the chunk and its transfers in n, -1 when done */
+off_t sd_dispget(struct sd_disp *disp, int pass, off_t *n)
+{
+	off_t k;
+
+	if (pass < 0 || pass >= disp->pass)
+		return -1;
+	/* a timed test ends the pass of all threads at the deadline */
+	if (sd_pastdue(disp->deadline))
+		return -1;
+	k = __sync_fetch_and_add(&disp->next[pass], disp->chunk);
+	if (k >= disp->total)
+		return -1;
+	*n = (disp->total - k < disp->chunk) ? disp->total - k : disp->chunk;
+
+	return k;
+}
+
 void sd_debug(const char *fmt, ...)
 {
 #ifdef DEBUG
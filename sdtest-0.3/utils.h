@@ -9,6 +9,10 @@
  * published by the Free Software Foundation.
  *
  * 2008-01-17 made initial version
+ * 2026-10-19 added dispenser of test space
+ *            added pattern fill and compare
+ *            added stratified placement of a partial coverage
+ *            added 'sd_pastdue' of timed tests
  *
  */
 
@@ -20,6 +24,7 @@
 /* get random number */
 extern int sd_randinit(void);
 extern off_t sd_randget(off_t);
+extern off_t sd_randxfer(off_t, off_t);
 
 /* get size shift bit */
 extern int sd_bitss(int);
@@ -27,6 +32,24 @@ extern int sd_bitss(int);
 /* get byte value from input */
 extern size_t sd_bytebox(char *, int);
 
+/* fill and check the test pattern, big endian in every 4 bytes */
+extern void sd_patfill(char *, int, unsigned);
+extern int sd_patcmp(const char *, int, unsigned);
+
+/* claim chunks of transfers from the dispenser */
+struct sd_disp;
+extern int sd_dispinit(struct sd_disp *, off_t, off_t, off_t, int, int, int);
+extern void sd_dispexit(struct sd_disp *);
+extern off_t sd_dispget(struct sd_disp *, int, off_t *);
+
+/* the deadline of a timed test passed, never for NULL */
+struct timespec;
+extern int sd_pastdue(const struct timespec *);
+
+/* place the k-th of the transfers of a partial coverage in its stratum */
+extern void sd_strataseed(unsigned long long);
+extern off_t sd_stratum(off_t, off_t, off_t);
+
 /* print debug messages */
 extern void sd_debug(const char *, ...);
 
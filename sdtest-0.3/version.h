@@ -1 +1 @@
-#define VER_STR		"Scsi Disk Test Version 0.3-pre3 (c) 2008 Jabil, Inc."
+#define VER_STR		"Scsi Disk Test Version 0.4-pre1 (c) 2008 Jabil, Inc."